@@ -0,0 +1,128 @@
+/**
+* File : vector3SSE.h
+* Description : 3D Math library : SSE specialization of CVector3<float>.
+* The 3 coordinates are padded with a 4th one (always ignored) so that a
+* vector fits in a SSE register. The operations are done lane by lane in the
+* same order as the generic version, so both give exactly the same results.
+* Included by Vector3.h when SSE2 is available and MATH_NO_SIMD is not defined.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef VECTOR3SSE_H
+#define VECTOR3SSE_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include <emmintrin.h>
+#include <math.h>
+
+//--------------------------------------------------------------------- CLASSES
+
+template <>
+class CVector3<float>
+{
+public :
+	/**
+	 *  vector values (w is only used as padding)
+	 */
+	union {
+		struct {
+			float x, y, z, w;
+		};
+		__m128 m;
+	};
+
+	CVector3(float X = 0, float Y = 0, float Z = 0) : m(_mm_setr_ps(X, Y, Z, 0)) {}
+	CVector3(const CVector3& v) : m(v.m) {}
+	explicit CVector3(__m128 v) : m(v) {}
+	CVector3& operator =(const CVector3& v) { m = v.m; return *this; }
+
+	void Set(float X, float Y, float Z) { m = _mm_setr_ps(X, Y, Z, 0); }
+	float Length() const { return sqrtf(LengthSq()); }
+	float LengthSq() const { return HorizontalSum(_mm_mul_ps(m, m)); }
+	void Normalize()
+	{
+		float Norm = Length();
+		if (fabs(Norm) > std::numeric_limits<float>::epsilon())
+			m = _mm_div_ps(m, _mm_set1_ps(Norm));
+	}
+
+	CVector3<float> operator +() const { return *this; }
+	CVector3<float> operator -() const { return CVector3<float>(_mm_sub_ps(_mm_setzero_ps(), m)); }
+
+	CVector3<float> operator +(const CVector3<float>& v) const { return CVector3<float>(_mm_add_ps(m, v.m)); }
+	CVector3<float> operator -(const CVector3<float>& v) const { return CVector3<float>(_mm_sub_ps(m, v.m)); }
+	CVector3<float> operator *(const CVector3<float>& v) const { return CVector3<float>(_mm_mul_ps(m, v.m)); }
+
+	const CVector3<float>& operator +=(const CVector3<float>& v) { m = _mm_add_ps(m, v.m); return *this; }
+	const CVector3<float>& operator -=(const CVector3<float>& v) { m = _mm_sub_ps(m, v.m); return *this; }
+
+	const CVector3<float>& operator *=(float t) { m = _mm_mul_ps(m, _mm_set1_ps(t)); return *this; }
+	const CVector3<float>& operator /=(float t) { m = _mm_div_ps(m, _mm_set1_ps(t)); return *this; }
+
+	bool operator ==(const CVector3<float>& v) const
+	{
+		return ((std::abs(x - v.x) <= std::numeric_limits<float>::epsilon()) &&
+				(std::abs(y - v.y) <= std::numeric_limits<float>::epsilon()) &&
+				(std::abs(z - v.z) <= std::numeric_limits<float>::epsilon()));
+	}
+	bool operator !=(const CVector3<float>& v) const { return !(*this == v); }
+	bool operator <(const CVector3<float>& v) const { return (x < v.x && y < v.y && z < v.z); }
+	bool operator >(const CVector3<float>& v) const { return (x > v.x && y > v.y && z > v.z); }
+
+	operator float*() { return &x; }
+
+	CVector3<float> operator *(const float f) const { return CVector3<float>(_mm_mul_ps(m, _mm_set1_ps(f))); }
+	CVector3<float>& operator*=(const Mat4x4& mat);
+
+	/**
+	 * @return (v.x + v.y) + v.z, the order used by the generic version.
+	 */
+	static float HorizontalSum(__m128 v)
+	{
+		__m128 s = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehl_ps(v, v)));
+	}
+};
+
+//------------------------------------------------------------------- FUNCTIONS
+
+/**
+ *  Global functions : these overloads are preferred to the generic templates.
+ */
+inline CVector3<float> operator /(const CVector3<float>& v, float t)
+{
+	return CVector3<float>(_mm_div_ps(v.m, _mm_set1_ps(t)));
+}
+
+inline CVector3<float> operator /(float t, const CVector3<float>& v)
+{
+	// keep the padding to 0 instead of t/0
+	const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	return CVector3<float>(_mm_and_ps(_mm_div_ps(_mm_set1_ps(t), v.m), mask));
+}
+
+inline float Dot(const CVector3<float>& v1, const CVector3<float>& v2)
+{
+	return CVector3<float>::HorizontalSum(_mm_mul_ps(v1.m, v2.m));
+}
+
+inline CVector3<float> Cross(const CVector3<float>& v1, const CVector3<float>& v2)
+{
+	// (y, z, x) permutations of both vectors
+	__m128 a = _mm_shuffle_ps(v1.m, v1.m, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 b = _mm_shuffle_ps(v2.m, v2.m, _MM_SHUFFLE(3, 0, 2, 1));
+	// (z, x, y) components of the cross product
+	__m128 c = _mm_sub_ps(_mm_mul_ps(v1.m, b), _mm_mul_ps(a, v2.m));
+	return CVector3<float>(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)));
+}
+
+inline CVector3<float>& CVector3<float>::operator*=(const Mat4x4& mat)
+{
+	*this = *this * mat;
+	return *this;
+}
+
+#endif // VECTOR3SSE_H
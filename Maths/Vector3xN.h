@@ -0,0 +1,184 @@
+/**
+* File : vector3xN.h
+* Description : 3D Math library : packets of 4, 8 or 16 3D vectors.
+* The coordinates are stored as a structure of arrays (one register per
+* coordinate) so the same operation is applied to all the vectors of a packet
+* at once. The lanes use the vector extension of gcc : the compiler emits
+* SSE/AVX instructions when they are enabled and splits the operations into
+* narrower registers or scalar code otherwise.
+* Everything is declared in an unnamed namespace : each file gets its own copy
+* of the functions, compiled with its own instruction set (see kernels.h).
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef VECTOR3XN_H
+#define VECTOR3XN_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include <string.h>
+#include <math.h>
+#include "Vector3.h"
+
+#ifdef __SSE__
+	#include <immintrin.h>
+#endif
+
+namespace {
+
+//----------------------------------------------------------------------- TYPES
+typedef float Float4 __attribute__ ((vector_size (16)));
+typedef float Float8 __attribute__ ((vector_size (32)));
+typedef float Float16 __attribute__ ((vector_size (64)));
+// masks returned by the comparisons of Float4, Float8 and Float16
+typedef int Int4 __attribute__ ((vector_size (16)));
+typedef int Int8 __attribute__ ((vector_size (32)));
+typedef int Int16 __attribute__ ((vector_size (64)));
+
+//------------------------------------------------------------------- FUNCTIONS
+
+/**
+ * @return a packet whose lanes are all equal to f.
+ */
+template <class F> inline F Splat(float f)
+{
+	F v = F();
+	return v + f;
+}
+
+/**
+ * Loads a packet from memory (no alignment required).
+ */
+template <class F> inline F Load(const float* p)
+{
+	F v;
+	memcpy(&v, p, sizeof(F));
+	return v;
+}
+
+/**
+ * @return a if the mask is set, b otherwise (mask is the result of a comparison).
+ */
+template <class F, class M> inline F Select(M mask, F a, F b)
+{
+	return (F)((mask & (M)a) | (~mask & (M)b));
+}
+
+template <class F> inline F Min(F a, F b) { return Select(a < b, a, b); }
+template <class F> inline F Max(F a, F b) { return Select(a > b, a, b); }
+
+/**
+ * @return the minimum of the lanes of v.
+ */
+template <class F> inline float HorizontalMin(F v)
+{
+	float m = v[0];
+	for(unsigned int i = 1; i < sizeof(F) / sizeof(float); i++)
+		if(v[i] < m)
+			m = v[i];
+	return m;
+}
+
+template <class F> inline F Sqrt(F v)
+{
+	for(unsigned int i = 0; i < sizeof(F) / sizeof(float); i++)
+		v[i] = sqrtf(v[i]);
+	return v;
+}
+
+#ifdef __SSE__
+template <> inline Float4 Sqrt(Float4 v) { return _mm_sqrt_ps(v); }
+#endif
+#ifdef __AVX__
+template <> inline Float8 Sqrt(Float8 v) { return _mm256_sqrt_ps(v); }
+#endif
+#ifdef __AVX512F__
+// the masked form doesn't read the undefined vector of _mm512_sqrt_ps, which
+// GCC reports as maybe uninitialized
+template <> inline Float16 Sqrt(Float16 v) { return _mm512_mask_sqrt_ps(v, (__mmask16)-1, v); }
+#endif
+
+//--------------------------------------------------------------------- CLASSES
+
+template <class F>
+class CVector3xN
+{
+public :
+	enum { SIZE = sizeof(F) / sizeof(float) };
+
+	/**
+	 *  coordinates of the vectors of the packet
+	 */
+	F x, y, z;
+
+	CVector3xN() : x(F()), y(F()), z(F()) {}
+	CVector3xN(F X, F Y, F Z) : x(X), y(Y), z(Z) {}
+	// same vector in all the lanes
+	explicit CVector3xN(const Vector3& v) : x(Splat<F>(v.x)), y(Splat<F>(v.y)), z(Splat<F>(v.z)) {}
+
+	/**
+	 * Loads SIZE vectors whose coordinates are stored in separate arrays.
+	 */
+	void Load(const float* X, const float* Y, const float* Z)
+	{
+		x = ::Load<F>(X);
+		y = ::Load<F>(Y);
+		z = ::Load<F>(Z);
+	}
+
+	void Set(int lane, const Vector3& v) { x[lane] = v.x; y[lane] = v.y; z[lane] = v.z; }
+	Vector3 Get(int lane) const { return Vector3(x[lane], y[lane], z[lane]); }
+
+	F LengthSq() const { return x * x + y * y + z * z; }
+	F Length() const { return Sqrt(LengthSq()); }
+
+	CVector3xN<F> operator -() const { return CVector3xN<F>(-x, -y, -z); }
+
+	CVector3xN<F> operator +(const CVector3xN<F>& v) const { return CVector3xN<F>(x + v.x, y + v.y, z + v.z); }
+	CVector3xN<F> operator -(const CVector3xN<F>& v) const { return CVector3xN<F>(x - v.x, y - v.y, z - v.z); }
+	CVector3xN<F> operator *(const CVector3xN<F>& v) const { return CVector3xN<F>(x * v.x, y * v.y, z * v.z); }
+	CVector3xN<F> operator *(F t) const { return CVector3xN<F>(x * t, y * t, z * t); }
+
+	const CVector3xN<F>& operator +=(const CVector3xN<F>& v) { x += v.x; y += v.y; z += v.z; return *this; }
+	const CVector3xN<F>& operator -=(const CVector3xN<F>& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+	const CVector3xN<F>& operator *=(F t) { x *= t; y *= t; z *= t; return *this; }
+};
+
+template <class F> inline CVector3xN<F> operator *(F t, const CVector3xN<F>& v)
+{
+	return v * t;
+}
+
+template <class F> inline F Dot(const CVector3xN<F>& v1, const CVector3xN<F>& v2)
+{
+	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
+
+template <class F> inline CVector3xN<F> Cross(const CVector3xN<F>& v1, const CVector3xN<F>& v2)
+{
+	return CVector3xN<F>(v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x);
+}
+
+/**
+ * Normalizes the vectors of a packet (the null vectors are left unchanged).
+ */
+template <class F> inline void Normalize(CVector3xN<F>& v)
+{
+	F norm = v.Length();
+	F one = Splat<F>(1.0f);
+	norm = Select(norm > Splat<F>(std::numeric_limits<float>::epsilon()), norm, one);
+	v.x /= norm;
+	v.y /= norm;
+	v.z /= norm;
+}
+
+//----------------------------------------------------------------------- TYPES
+typedef CVector3xN<Float4> Vector3x4;
+typedef CVector3xN<Float8> Vector3x8;
+typedef CVector3xN<Float16> Vector3x16;
+
+} // namespace
+
+#endif // VECTOR3XN_H
@@ -0,0 +1,1260 @@
+/**
+* File : bvh.cpp
+* Description : Bounding volume hierarchy built over a set of primitives.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "bvh.h"
+#include "defs.h"
+
+#include <algorithm>
+
+//--------------------------------------------------------------------- HELPERS
+
+/**
+ * Orders primitives by the coordinate of their centroid along an axis
+ */
+struct CentroidLess
+{
+	int m_Axis;
+
+	CentroidLess(int axis):m_Axis(axis){}
+	bool operator()(const BVHPrimitive& a, const BVHPrimitive& b) const
+	{
+		return (&a.centroid.x)[m_Axis] < (&b.centroid.x)[m_Axis];
+	}
+};
+
+/**
+ * Selects the primitives whose centroid falls in the bins before a split
+ */
+struct CentroidBinLess
+{
+	int m_Axis;
+	float m_Min, m_Scale; // start of the bins and number of bins per unit
+	int m_Split; // first bin after the split
+
+	CentroidBinLess(int axis, float min, float scale, int split):
+		m_Axis(axis),m_Min(min),m_Scale(scale),m_Split(split){}
+	bool operator()(const BVHPrimitive& p) const
+	{
+		return GetBin((&p.centroid.x)[m_Axis], m_Min, m_Scale) < m_Split;
+	}
+	static int GetBin(float c, float min, float scale)
+	{
+		int bin = (int)((c - min) * scale);
+		return (bin < 0) ? 0 : ((bin >= BVH_BINS) ? BVH_BINS - 1 : bin);
+	}
+};
+
+/**
+ * @return the bits of v (10 bits) spread to every third bit.
+ */
+static unsigned int SpreadBits(unsigned int v)
+{
+	v = (v * 0x00010001u) & 0xFF0000FFu;
+	v = (v * 0x00000101u) & 0x0F00F00Fu;
+	v = (v * 0x00000011u) & 0xC30C30C3u;
+	v = (v * 0x00000005u) & 0x49249249u;
+	return v;
+}
+
+/**
+ * @return the coordinate f quantized to BVH_MORTON_BITS bits.
+ */
+static unsigned int Quantize(float f)
+{
+	const float max = (float)((1 << BVH_MORTON_BITS) - 1);
+	f *= max + 1;
+	return (unsigned int)((f < 0) ? 0 : ((f > max) ? max : f));
+}
+
+/**
+ * @return true if the box contains no point (see the default Box).
+ */
+static inline bool IsEmpty(const Box& box)
+{
+	const Vector3 min = box.GetMin(), max = box.GetMax();
+	return !(min.x <= max.x && min.y <= max.y && min.z <= max.z);
+}
+
+/**
+ * @return the box between min and max, which may be flat (unlike the
+ * constructor of Box), or empty if max is below min along an axis.
+ */
+static Box MakeBox(const Vector3& min, const Vector3& max)
+{
+	Box box;
+	if(min.x <= max.x && min.y <= max.y && min.z <= max.z)
+	{
+		box.Extend(min);
+		box.Extend(max);
+	}
+	return box;
+}
+
+/**
+ * @return the common part of two boxes (empty if they don't overlap).
+ */
+static Box Intersection(const Box& a, const Box& b)
+{
+	const Vector3 amin = a.GetMin(), amax = a.GetMax(), bmin = b.GetMin(), bmax = b.GetMax();
+	return MakeBox(Vector3(std::max(amin.x, bmin.x), std::max(amin.y, bmin.y), std::max(amin.z, bmin.z)),
+		Vector3(std::min(amax.x, bmax.x), std::min(amax.y, bmax.y), std::min(amax.z, bmax.z)));
+}
+
+/**
+ * Orders references by the coordinate of the center of their bounds along an
+ * axis
+ */
+struct ReferenceLess
+{
+	int m_Axis;
+
+	ReferenceLess(int axis):m_Axis(axis){}
+	bool operator()(const BVHReference& a, const BVHReference& b) const
+	{
+		Vector3 ca = a.bounds.GetCenter(), cb = b.bounds.GetCenter();
+		return (&ca.x)[m_Axis] < (&cb.x)[m_Axis];
+	}
+};
+
+/**
+ * Sweeps BVH_BINS bins from both sides to find the split between two bins
+ * with the lowest SAH cost (without the area of the node).
+ * @param entries, exits number of references starting and ending in each bin
+ * (both are the number of primitives of each bin for an object split).
+ * @param bestCost, bestSplit cost of the best split found so far and index of
+ * its first bin, updated if a better split is found.
+ * @return true if a better split was found.
+ */
+static bool SweepBins(const Box bins[], const int entries[], const int exits[],
+	float& bestCost, int& bestSplit)
+{
+	// area and number of references of the bins [split, BVH_BINS[
+	float rightArea[BVH_BINS];
+	int rightCount[BVH_BINS];
+	Box right;
+	int n = 0;
+	for(int split = BVH_BINS - 1; split > 0; split--)
+	{
+		if(!IsEmpty(bins[split]))
+			right.Extend(bins[split]);
+		n += exits[split];
+		rightArea[split] = right.GetArea();
+		rightCount[split] = n;
+	}
+
+	bool found = false;
+	Box left;
+	n = 0;
+	for(int split = 1; split < BVH_BINS; split++)
+	{
+		if(!IsEmpty(bins[split - 1]))
+			left.Extend(bins[split - 1]);
+		n += entries[split - 1];
+		if(n == 0 || rightCount[split] == 0)
+			continue;
+		float cost = n * left.GetArea() + rightCount[split] * rightArea[split];
+		if(cost < bestCost)
+		{
+			bestCost = cost;
+			bestSplit = split;
+			found = true;
+		}
+	}
+	return found;
+}
+
+/**
+ * Appends the nodes of a subtree built in its own array (see
+ * BVH::BuildChildren).
+ * @return the index of the root of the subtree in nodes.
+ */
+static int AppendNodes(vector<BVHNode>& nodes, const vector<BVHNode>& subtree)
+{
+	const int offset = (int)nodes.size();
+	nodes.insert(nodes.end(), subtree.begin(), subtree.end());
+	for(int i = offset; i < (int)nodes.size(); i++)
+	{
+		if(nodes[i].count == 0)
+			nodes[i].first += offset;
+	}
+	return offset;
+}
+
+/**
+ * Runs the nbTasks tasks at the same time : the first one on the calling
+ * thread, the others on their own thread.
+ * @param run function running a task.
+ */
+template <class Task>
+static void RunTasks(Task tasks[], int nbTasks, int (*run)(void*))
+{
+	SDL_Thread* threads[BVH_BUILD_THREADS];
+	for(int t = 1; t < nbTasks; t++)
+		threads[t] = SDL_CreateThread(run, &tasks[t]);
+	run(&tasks[0]);
+	for(int t = 1; t < nbTasks; t++)
+	{
+		// without thread, the task is run by the calling thread
+		if(threads[t])
+			SDL_WaitThread(threads[t], 0);
+		else
+			run(&tasks[t]);
+	}
+}
+
+/**
+ * Part of the primitives sorted by a thread in a pass of the radix sort of
+ * BVH::SortMorton
+ */
+struct RadixSortTask
+{
+	const unsigned int* codes;
+	const int* indices;
+	unsigned int* sortedCodes;
+	int* sortedIndices;
+	int begin, end;
+	int shift; // first bit of the pass
+	// number of codes of the part in each bucket, then next destination
+	int offsets[1 << BVH_MORTON_BITS];
+};
+
+/**
+ * Counts the codes of a part in each bucket of the pass.
+ * @param task the RadixSortTask of the part.
+ */
+static int CountBuckets(void* task)
+{
+	RadixSortTask& t = *(RadixSortTask*)task;
+	const unsigned int mask = (1 << BVH_MORTON_BITS) - 1;
+	std::fill_n(t.offsets, 1 << BVH_MORTON_BITS, 0);
+	for(int i = t.begin; i < t.end; i++)
+		t.offsets[(t.codes[i] >> t.shift) & mask]++;
+	return 0;
+}
+
+/**
+ * Moves the codes of a part and their indices to their bucket.
+ * @param task the RadixSortTask of the part.
+ */
+static int ScatterBuckets(void* task)
+{
+	RadixSortTask& t = *(RadixSortTask*)task;
+	const unsigned int mask = (1 << BVH_MORTON_BITS) - 1;
+	for(int i = t.begin; i < t.end; i++)
+	{
+		int dest = t.offsets[(t.codes[i] >> t.shift) & mask]++;
+		t.sortedCodes[dest] = t.codes[i];
+		t.sortedIndices[dest] = t.indices[i];
+	}
+	return 0;
+}
+
+/**
+ * @return the number of threads among which the passes over the primitives of
+ * a node of the given depth are split : the threads not taken by the subtrees
+ * built at the same time (see BVH::BuildChildren), each with at least
+ * BVH_PARALLEL_SIZE primitives.
+ */
+static int GetNbNodeTasks(int count, int depth)
+{
+	int threads = (depth < 8) ? BVH_BUILD_THREADS >> depth : 0;
+	return std::max(std::min(threads, count / BVH_PARALLEL_SIZE), 1);
+}
+
+/**
+ * Splits the primitives [begin..end[ of a node in equal parts.
+ */
+template <class Task>
+static void SplitNodeTasks(vector<Task>& tasks, int begin, int end)
+{
+	const int nbTasks = (int)tasks.size();
+	for(int t = 0; t < nbTasks; t++)
+	{
+		tasks[t].begin = begin + (int)((long long)(end - begin) * t / nbTasks);
+		tasks[t].end = begin + (int)((long long)(end - begin) * (t + 1) / nbTasks);
+	}
+}
+
+/**
+ * Part of the primitives of a large node whose bounds or bins are gathered by
+ * a thread (see BVH::BuildNode and BVH::SplitSAH)
+ */
+struct BinTask
+{
+	const BVHPrimitive* prims;
+	int begin, end;
+	// bounds of the primitives of the part and of their centroids
+	Box bounds, centroidBounds;
+	// start of the bins and number of bins per unit along each axis
+	const float* min;
+	const float* scale;
+	Box binBounds[3][BVH_BINS];
+	int binCounts[3][BVH_BINS];
+};
+
+/**
+ * Computes the bounds of the primitives of a part and of their centroids.
+ * @param task the BinTask of the part.
+ */
+static int ComputeBounds(void* task)
+{
+	BinTask& t = *(BinTask*)task;
+	for(int i = t.begin; i < t.end; i++)
+	{
+		t.bounds.Extend(t.prims[i].bounds);
+		t.centroidBounds.Extend(t.prims[i].centroid);
+	}
+	return 0;
+}
+
+/**
+ * Gathers the primitives of a part in the bins of their centroid along each
+ * axis.
+ * @param task the BinTask of the part.
+ */
+static int BinCentroids(void* task)
+{
+	BinTask& t = *(BinTask*)task;
+	std::fill_n(&t.binCounts[0][0], 3 * BVH_BINS, 0);
+	for(int i = t.begin; i < t.end; i++)
+	{
+		const float* c = &t.prims[i].centroid.x;
+		for(int axis = 0; axis < 3; axis++)
+		{
+			int bin = CentroidBinLess::GetBin(c[axis], t.min[axis], t.scale[axis]);
+			t.binCounts[axis][bin]++;
+			t.binBounds[axis][bin].Extend(t.prims[i].bounds);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Part of the primitives of a large node partitioned by a thread (see
+ * BVH::SplitSAH)
+ */
+struct PartitionTask
+{
+	BVHPrimitive* prims;
+	BVHPrimitive* sorted; // partitioned primitives of the node
+	int first; // first primitive of the node
+	int begin, end;
+	const CentroidBinLess* less;
+	// number of primitives of the part before the split, then next
+	// destination of the primitives before and after the split
+	int left, right;
+};
+
+/**
+ * Counts the primitives of a part before the split.
+ * @param task the PartitionTask of the part.
+ */
+static int CountSplit(void* task)
+{
+	PartitionTask& t = *(PartitionTask*)task;
+	t.left = 0;
+	for(int i = t.begin; i < t.end; i++)
+		t.left += (*t.less)(t.prims[i]);
+	return 0;
+}
+
+/**
+ * Moves the primitives of a part to their side of the split.
+ * @param task the PartitionTask of the part.
+ */
+static int ScatterSplit(void* task)
+{
+	PartitionTask& t = *(PartitionTask*)task;
+	for(int i = t.begin; i < t.end; i++)
+		t.sorted[(*t.less)(t.prims[i]) ? t.left++ : t.right++] = t.prims[i];
+	return 0;
+}
+
+/**
+ * Copies the partitioned primitives of a part back to the node.
+ * @param task the PartitionTask of the part.
+ */
+static int CopySplit(void* task)
+{
+	PartitionTask& t = *(PartitionTask*)task;
+	std::copy(t.sorted + t.begin - t.first, t.sorted + t.end - t.first, t.prims + t.begin);
+	return 0;
+}
+
+/**
+ * Subtree of the primitives prims[begin..end[ built by a thread in its own
+ * array of nodes
+ */
+struct BVH::BuildTask
+{
+	BVH* bvh;
+	vector<BVHPrimitive>* prims;
+	const vector<unsigned int>* codes; // Morton codes (0 for an object split build)
+	int begin, end;
+	int maxLeafSize;
+	int depth;
+	vector<BVHNode> nodes;
+};
+
+/**
+ * Subtree of the nodes m_Nodes[begin..end[ refitted by a thread
+ */
+struct BVH::RefitTask
+{
+	BVH* bvh;
+	const vector<Box>* primBounds;
+	int begin, end;
+};
+
+//--------------------------------------------------------------------- METHODS
+
+/**
+ * Build the hierarchy : the primitives are recursively split in two (see
+ * SetSplitMethod).
+ * @param primBounds bounding box of each primitive.
+ * @param maxLeafSize maximum number of primitives in a leaf.
+ */
+void BVH::Build(const vector<Box>& primBounds, int maxLeafSize)
+{
+	Clear();
+	if(primBounds.empty())
+		return;
+
+	const int nbPrims = (int)primBounds.size();
+	m_Nodes.reserve(2 * nbPrims / maxLeafSize + 1);
+	if(m_Split == BVH_SPLIT_SPATIAL)
+	{
+		vector<BVHReference> refs(nbPrims);
+		Box bounds;
+		for(int i = 0; i < nbPrims; i++)
+		{
+			refs[i].prim = i;
+			refs[i].bounds = primBounds[i];
+			bounds.Extend(primBounds[i]);
+		}
+		// the leaves add the references to m_Indices
+		m_NbRefs = nbPrims;
+		m_MaxRefs = (int)(nbPrims * (1.0f + m_MaxDuplication));
+		m_MinOverlap = BVH_SPATIAL_OVERLAP * bounds.GetArea();
+		BuildSpatialNode(primBounds, refs, maxLeafSize, 0);
+		m_BuildCost = GetCost();
+		return;
+	}
+
+	vector<BVHPrimitive> prims(nbPrims);
+	for(int i = 0; i < nbPrims; i++)
+	{
+		prims[i].bounds = primBounds[i];
+		prims[i].centroid = primBounds[i].GetCenter();
+		prims[i].prim = i;
+	}
+	m_Indices.resize(nbPrims);
+	if(m_Split == BVH_SPLIT_MORTON || m_Split == BVH_SPLIT_MORTON_SAH)
+	{
+		vector<unsigned int> codes;
+		SortMorton(prims, codes);
+		BuildMortonNode(m_Nodes, prims, codes, 0, nbPrims, maxLeafSize, 0);
+	}
+	else
+		BuildNode(m_Nodes, prims, 0, nbPrims, maxLeafSize, 0);
+	m_BuildCost = GetCost();
+}
+
+/**
+ * Recompute the bounds of the nodes from the new bounds of the primitives,
+ * keeping the tree. The top levels of the large hierarchies are split in
+ * disjoint subtrees refitted by several threads (the same way BuildChildren
+ * splits them), then the few nodes above them are refitted.
+ * @param primBounds bounding box of each primitive, in the order given to
+ * Build. After a spatial split build, the leaves take the whole bounds of the
+ * primitives they reference rather than the clipped parts : the hierarchy
+ * stays correct but looser.
+ */
+void BVH::Refit(const vector<Box>& primBounds)
+{
+	if(m_Nodes.empty())
+		return;
+
+	vector<int> top;
+	RefitTask tasks[BVH_BUILD_THREADS];
+	int nbTasks = 0;
+	SplitRefit(0, (int)m_Nodes.size(), 0, top, tasks, nbTasks);
+	for(int t = 0; t < nbTasks; t++)
+	{
+		tasks[t].bvh = this;
+		tasks[t].primBounds = &primBounds;
+	}
+	RunTasks(tasks, nbTasks, RefitSubtree);
+
+	// the children of a node come after it in top
+	for(int k = (int)top.size() - 1; k >= 0; k--)
+		RefitNodes(primBounds, top[k], top[k] + 1);
+}
+
+/**
+ * Splits the subtree of the nodes m_Nodes[index..end[ between the tasks of
+ * Refit : the large inner nodes of the top levels are kept in top and their
+ * children are split again, the other subtrees become tasks.
+ */
+void BVH::SplitRefit(int index, int end, int depth, vector<int>& top, RefitTask tasks[],
+	int& nbTasks)
+{
+	const BVHNode& node = m_Nodes[index];
+	if(node.count == 0 && (2 << depth) <= BVH_BUILD_THREADS && end - index >= BVH_PARALLEL_SIZE)
+	{
+		// the first child is stored right after the node, the second after
+		// the subtree of the first one
+		top.push_back(index);
+		SplitRefit(index + 1, node.first, depth + 1, top, tasks, nbTasks);
+		SplitRefit(node.first, end, depth + 1, top, tasks, nbTasks);
+		return;
+	}
+	tasks[nbTasks].begin = index;
+	tasks[nbTasks].end = end;
+	nbTasks++;
+}
+
+/**
+ * Entry point of the threads of Refit.
+ * @param task the RefitTask of the subtree.
+ */
+int BVH::RefitSubtree(void* task)
+{
+	RefitTask& t = *(RefitTask*)task;
+	t.bvh->RefitNodes(*t.primBounds, t.begin, t.end);
+	return 0;
+}
+
+/**
+ * Recompute the bounds of the nodes m_Nodes[begin..end[, whose children are
+ * either in the range or already refitted. The children of a node are stored
+ * after it, so the nodes are visited in reverse order (bottom-up) in a single
+ * pass.
+ */
+void BVH::RefitNodes(const vector<Box>& primBounds, int begin, int end)
+{
+	for(int index = end - 1; index >= begin; index--)
+	{
+		BVHNode& node = m_Nodes[index];
+		Box bounds;
+		if(node.count > 0)
+		{
+			for(int i = node.first; i < node.first + node.count; i++)
+				bounds.Extend(primBounds[m_Indices[i]]);
+		}
+		else
+		{
+			bounds.Extend(m_Nodes[index + 1].bounds);
+			bounds.Extend(m_Nodes[node.first].bounds);
+		}
+		node.bounds = bounds;
+	}
+}
+
+/**
+ * Surface area heuristic : expected cost of a ray hitting the root, the
+ * probability of hitting a node being the ratio of its area to the area of
+ * the root.
+ */
+float BVH::GetCost() const
+{
+	if(m_Nodes.empty())
+		return 0;
+	float rootArea = m_Nodes[0].bounds.GetArea();
+	if(rootArea <= 0)
+		return 0;
+
+	float cost = 0;
+	for(size_t i = 0; i < m_Nodes.size(); i++)
+	{
+		const BVHNode& node = m_Nodes[i];
+		float c = (node.count > 0) ? node.count * m_IntersectionCost : BVH_TRAVERSAL_COST;
+		cost += c * node.bounds.GetArea();
+	}
+	return cost / rootArea;
+}
+
+/**
+ * Build the node containing the primitives prims[begin..end[, which are
+ * reordered by the splits. The leaves copy their primitives to m_Indices.
+ * @param nodes array receiving the node and its children.
+ * @return index of the node.
+ */
+int BVH::BuildNode(vector<BVHNode>& nodes, vector<BVHPrimitive>& prims, int begin, int end,
+	int maxLeafSize, int depth)
+{
+	int index = (int)nodes.size();
+	nodes.push_back(BVHNode());
+
+	Box bounds, centroidBounds;
+	const int nbTasks = GetNbNodeTasks(end - begin, depth);
+	if(nbTasks > 1)
+	{
+		vector<BinTask> tasks(nbTasks);
+		SplitNodeTasks(tasks, begin, end);
+		for(int t = 0; t < nbTasks; t++)
+			tasks[t].prims = &prims[0];
+		RunTasks(&tasks[0], nbTasks, ComputeBounds);
+		for(int t = 0; t < nbTasks; t++)
+		{
+			bounds.Extend(tasks[t].bounds);
+			centroidBounds.Extend(tasks[t].centroidBounds);
+		}
+	}
+	else
+	{
+		for(int i = begin; i < end; i++)
+		{
+			bounds.Extend(prims[i].bounds);
+			centroidBounds.Extend(prims[i].centroid);
+		}
+	}
+	nodes[index].bounds = bounds;
+
+	int mid = -1;
+	if(depth < BVH_STACK_SIZE - 2 && end - begin > 1)
+	{
+		if(m_Split != BVH_SPLIT_MEDIAN)
+			mid = SplitSAH(prims, begin, end, bounds, centroidBounds, maxLeafSize, depth);
+		// without SAH split (or with all the centroids at the same place)
+		if(mid < 0 && end - begin > maxLeafSize)
+			mid = SplitMedian(prims, begin, end, centroidBounds);
+	}
+	if(mid < 0)
+	{
+		nodes[index].first = begin;
+		nodes[index].count = end - begin;
+		for(int i = begin; i < end; i++)
+			m_Indices[i] = prims[i].prim;
+		return index;
+	}
+
+	int second = BuildChildren(nodes, prims, 0, begin, mid, end, maxLeafSize, depth);
+	nodes[index].first = second;
+	nodes[index].count = 0;
+	return index;
+}
+
+/**
+ * Build the children of a node of the given depth, containing the primitives
+ * prims[begin..mid[ and prims[mid..end[ (see BuildNode, or BuildMortonNode if
+ * codes isn't 0). The children of the large nodes of the top levels are built
+ * by two threads, each in its own array of nodes : the nodes are appended in
+ * the same order as in a sequential build.
+ * @return index of the second child.
+ */
+int BVH::BuildChildren(vector<BVHNode>& nodes, vector<BVHPrimitive>& prims,
+	const vector<unsigned int>* codes, int begin, int mid, int end, int maxLeafSize,
+	int depth)
+{
+	if((2 << depth) <= BVH_BUILD_THREADS && mid - begin >= BVH_PARALLEL_SIZE
+		&& end - mid >= BVH_PARALLEL_SIZE)
+	{
+		BuildTask tasks[2];
+		for(int k = 0; k < 2; k++)
+		{
+			tasks[k].bvh = this;
+			tasks[k].prims = &prims;
+			tasks[k].codes = codes;
+			tasks[k].begin = (k == 0) ? begin : mid;
+			tasks[k].end = (k == 0) ? mid : end;
+			tasks[k].maxLeafSize = maxLeafSize;
+			tasks[k].depth = depth + 1;
+		}
+		RunTasks(tasks, 2, BuildSubtree);
+		AppendNodes(nodes, tasks[0].nodes);
+		return AppendNodes(nodes, tasks[1].nodes);
+	}
+
+	if(codes)
+	{
+		BuildMortonNode(nodes, prims, *codes, begin, mid, maxLeafSize, depth + 1);
+		return BuildMortonNode(nodes, prims, *codes, mid, end, maxLeafSize, depth + 1);
+	}
+	BuildNode(nodes, prims, begin, mid, maxLeafSize, depth + 1);
+	return BuildNode(nodes, prims, mid, end, maxLeafSize, depth + 1);
+}
+
+/**
+ * Entry point of the threads of BuildChildren.
+ * @param task the BuildTask of the subtree.
+ */
+int BVH::BuildSubtree(void* task)
+{
+	BuildTask& t = *(BuildTask*)task;
+	if(t.codes)
+		t.bvh->BuildMortonNode(t.nodes, *t.prims, *t.codes, t.begin, t.end, t.maxLeafSize,
+			t.depth);
+	else
+		t.bvh->BuildNode(t.nodes, *t.prims, t.begin, t.end, t.maxLeafSize, t.depth);
+	return 0;
+}
+
+/**
+ * Finds the best split of the primitives prims[begin..end[ with the surface
+ * area heuristic : the centroids are gathered in BVH_BINS bins along each
+ * axis (the 3 axes in a single pass over the primitives), and the costs of the
+ * splits between the bins are computed by sweeping the bins from both sides.
+ * The binning and the partition of the large nodes of the top levels are
+ * split between the threads left by the subtrees (see GetNbNodeTasks).
+ * @return the index of the first primitive of the second child, -1 if the
+ * primitives can't be split or if a leaf is cheaper (only for a leaf of at
+ * most maxLeafSize primitives).
+ */
+int BVH::SplitSAH(vector<BVHPrimitive>& prims, int begin, int end, const Box& bounds,
+	const Box& centroidBounds, int maxLeafSize, int depth) const
+{
+	const int count = end - begin;
+	const Vector3 cmin = centroidBounds.GetMin(), size = centroidBounds.GetSize();
+	const float* min = &cmin.x;
+	const float* extent = &size.x;
+	float scale[3];
+	for(int axis = 0; axis < 3; axis++)
+		scale[axis] = (extent[axis] > 0) ? BVH_BINS / extent[axis] : 0;
+
+	Box binBounds[3][BVH_BINS];
+	int binCounts[3][BVH_BINS] = {{0}};
+	const int nbTasks = GetNbNodeTasks(count, depth);
+	if(nbTasks > 1)
+	{
+		vector<BinTask> tasks(nbTasks);
+		SplitNodeTasks(tasks, begin, end);
+		for(int t = 0; t < nbTasks; t++)
+		{
+			tasks[t].prims = &prims[0];
+			tasks[t].min = min;
+			tasks[t].scale = scale;
+		}
+		RunTasks(&tasks[0], nbTasks, BinCentroids);
+		for(int t = 0; t < nbTasks; t++)
+		{
+			for(int axis = 0; axis < 3; axis++)
+			{
+				for(int bin = 0; bin < BVH_BINS; bin++)
+				{
+					binCounts[axis][bin] += tasks[t].binCounts[axis][bin];
+					binBounds[axis][bin].Extend(tasks[t].binBounds[axis][bin]);
+				}
+			}
+		}
+	}
+	else
+	{
+		for(int i = begin; i < end; i++)
+		{
+			const float* c = &prims[i].centroid.x;
+			for(int axis = 0; axis < 3; axis++)
+			{
+				int bin = CentroidBinLess::GetBin(c[axis], min[axis], scale[axis]);
+				binCounts[axis][bin]++;
+				binBounds[axis][bin].Extend(prims[i].bounds);
+			}
+		}
+	}
+
+	float bestCost = std::numeric_limits<float>::infinity();
+	int bestAxis = -1, bestSplit = 0;
+	for(int axis = 0; axis < 3; axis++)
+	{
+		if(extent[axis] > 0 && SweepBins(binBounds[axis], binCounts[axis], binCounts[axis],
+			bestCost, bestSplit))
+			bestAxis = axis;
+	}
+	if(bestAxis < 0)
+		return -1;
+
+	if(count <= maxLeafSize)
+	{
+		float area = bounds.GetArea();
+		if(!(area > 0))
+			return -1;
+		float splitCost = BVH_TRAVERSAL_COST + m_IntersectionCost * bestCost / area;
+		if(splitCost >= count * m_IntersectionCost)
+			return -1;
+	}
+
+	const CentroidBinLess less(bestAxis, min[bestAxis], scale[bestAxis], bestSplit);
+	if(nbTasks > 1)
+	{
+		// each part moves its primitives to the end of the primitives of the
+		// parts before it, on both sides of the split
+		vector<BVHPrimitive> sorted(count);
+		vector<PartitionTask> tasks(nbTasks);
+		SplitNodeTasks(tasks, begin, end);
+		for(int t = 0; t < nbTasks; t++)
+		{
+			tasks[t].prims = &prims[0];
+			tasks[t].sorted = &sorted[0];
+			tasks[t].first = begin;
+			tasks[t].less = &less;
+		}
+		RunTasks(&tasks[0], nbTasks, CountSplit);
+		int nbLeft = 0;
+		for(int t = 0; t < nbTasks; t++)
+			nbLeft += tasks[t].left;
+		int left = 0, right = nbLeft;
+		for(int t = 0; t < nbTasks; t++)
+		{
+			int n = tasks[t].left;
+			tasks[t].left = left;
+			tasks[t].right = right;
+			left += n;
+			right += tasks[t].end - tasks[t].begin - n;
+		}
+		RunTasks(&tasks[0], nbTasks, ScatterSplit);
+		RunTasks(&tasks[0], nbTasks, CopySplit);
+		return begin + nbLeft;
+	}
+	vector<BVHPrimitive>::iterator mid = std::partition(prims.begin() + begin,
+		prims.begin() + end, less);
+	return (int)(mid - prims.begin());
+}
+
+/**
+ * Splits the primitives prims[begin..end[ in two halves along the largest
+ * axis of the bounding box of their centroids.
+ * @return the index of the first primitive of the second child.
+ */
+int BVH::SplitMedian(vector<BVHPrimitive>& prims, int begin, int end,
+	const Box& centroidBounds)
+{
+	Vector3 size = centroidBounds.GetSize();
+	int axis = 0;
+	if(size.y > size.x) axis = 1;
+	if(size.z > ((axis == 0) ? size.x : size.y)) axis = 2;
+
+	int mid = (begin + end) / 2;
+	std::nth_element(prims.begin() + begin, prims.begin() + mid, prims.begin() + end,
+		CentroidLess(axis));
+	return mid;
+}
+
+/**
+ * Sorts the primitives by the Morton codes of their centroids, quantized in
+ * their bounding box (radix sort of their indices, BVH_MORTON_BITS bits per
+ * pass). Above BVH_PARALLEL_SIZE primitives, each pass is split between
+ * BVH_BUILD_THREADS threads : each thread counts the codes of its part in the
+ * buckets, then moves them after the codes of the previous parts.
+ * @param codes receives the sorted codes.
+ */
+void BVH::SortMorton(vector<BVHPrimitive>& prims, vector<unsigned int>& codes)
+{
+	const int nbPrims = (int)prims.size();
+	Box centroidBounds;
+	for(int i = 0; i < nbPrims; i++)
+		centroidBounds.Extend(prims[i].centroid);
+	const Vector3 min = centroidBounds.GetMin();
+	Vector3 size = centroidBounds.GetSize();
+	Vector3 scale(size.x > 0 ? 1.0f / size.x : 0, size.y > 0 ? 1.0f / size.y : 0,
+		size.z > 0 ? 1.0f / size.z : 0);
+
+	codes.resize(nbPrims);
+	for(int i = 0; i < nbPrims; i++)
+	{
+		Vector3 c = (prims[i].centroid - min) * scale;
+		codes[i] = (SpreadBits(Quantize(c.x)) << 2) | (SpreadBits(Quantize(c.y)) << 1)
+			| SpreadBits(Quantize(c.z));
+		m_Indices[i] = i;
+	}
+
+	const int nbBuckets = 1 << BVH_MORTON_BITS;
+	const int nbTasks = (nbPrims >= BVH_PARALLEL_SIZE) ? BVH_BUILD_THREADS : 1;
+	vector<unsigned int> sortedCodes(nbPrims);
+	vector<int> sortedIndices(nbPrims);
+	vector<RadixSortTask> tasks(nbTasks);
+	for(int t = 0; t < nbTasks; t++)
+	{
+		tasks[t].begin = (int)((long long)nbPrims * t / nbTasks);
+		tasks[t].end = (int)((long long)nbPrims * (t + 1) / nbTasks);
+	}
+	for(int shift = 0; shift < 3 * BVH_MORTON_BITS; shift += BVH_MORTON_BITS)
+	{
+		for(int t = 0; t < nbTasks; t++)
+		{
+			tasks[t].codes = &codes[0];
+			tasks[t].indices = &m_Indices[0];
+			tasks[t].sortedCodes = &sortedCodes[0];
+			tasks[t].sortedIndices = &sortedIndices[0];
+			tasks[t].shift = shift;
+		}
+		RunTasks(&tasks[0], nbTasks, CountBuckets);
+
+		// the parts keep their order inside each bucket (stable sort)
+		int sum = 0;
+		for(int b = 0; b < nbBuckets; b++)
+		{
+			for(int t = 0; t < nbTasks; t++)
+			{
+				int count = tasks[t].offsets[b];
+				tasks[t].offsets[b] = sum;
+				sum += count;
+			}
+		}
+		RunTasks(&tasks[0], nbTasks, ScatterBuckets);
+		codes.swap(sortedCodes);
+		m_Indices.swap(sortedIndices);
+	}
+
+	vector<BVHPrimitive> sorted(nbPrims);
+	for(int i = 0; i < nbPrims; i++)
+		sorted[i] = prims[m_Indices[i]];
+	prims.swap(sorted);
+}
+
+/**
+ * Build the node containing the primitives prims[begin..end[, sorted by their
+ * Morton codes : the range is split where the highest bit differing between
+ * the first and the last codes changes. Each node is built once, so the whole
+ * hierarchy is built in linear time (the top subtrees in parallel, see
+ * BuildChildren).
+ * @return index of the node.
+ */
+int BVH::BuildMortonNode(vector<BVHNode>& nodes, vector<BVHPrimitive>& prims,
+	const vector<unsigned int>& codes, int begin, int end, int maxLeafSize, int depth)
+{
+	if(m_Split == BVH_SPLIT_MORTON_SAH && end - begin <= BVH_TREELET_SIZE)
+		return BuildNode(nodes, prims, begin, end, maxLeafSize, depth);
+
+	int index = (int)nodes.size();
+	nodes.push_back(BVHNode());
+	if(end - begin <= maxLeafSize || depth >= BVH_STACK_SIZE - 2)
+	{
+		Box bounds;
+		for(int i = begin; i < end; i++)
+			bounds.Extend(prims[i].bounds);
+		nodes[index].bounds = bounds;
+		nodes[index].first = begin;
+		nodes[index].count = end - begin;
+		return index;
+	}
+
+	int mid = (begin + end) / 2;
+	unsigned int diff = codes[begin] ^ codes[end - 1];
+	if(diff != 0)
+	{
+		// first code with the highest differing bit set
+		int bit = 31;
+		while(!(diff & (1u << bit)))
+			bit--;
+		vector<unsigned int>::const_iterator first = std::upper_bound(codes.begin() + begin,
+			codes.begin() + end, codes[begin] | ((1u << bit) - 1));
+		mid = (int)(first - codes.begin());
+	}
+
+	int second = BuildChildren(nodes, prims, &codes, begin, mid, end, maxLeafSize, depth);
+	Box bounds = nodes[index + 1].bounds;
+	bounds.Extend(nodes[second].bounds);
+	nodes[index].bounds = bounds;
+	nodes[index].first = second;
+	nodes[index].count = 0;
+	return index;
+}
+
+/**
+ * Build the node containing the references refs (emptied), choosing the
+ * cheapest of the best object split and of the best spatial split. The
+ * spatial splits are only tried when the children of the object split
+ * overlap, and as long as the number of references stays under the limit
+ * given by SetMaxDuplication.
+ * @return index of the node.
+ */
+int BVH::BuildSpatialNode(const vector<Box>& primBounds, vector<BVHReference>& refs,
+	int maxLeafSize, int depth)
+{
+	int index = (int)m_Nodes.size();
+	m_Nodes.push_back(BVHNode());
+
+	const int count = (int)refs.size();
+	Box bounds, centroidBounds;
+	for(int i = 0; i < count; i++)
+	{
+		bounds.Extend(refs[i].bounds);
+		centroidBounds.Extend(refs[i].bounds.GetCenter());
+	}
+	m_Nodes[index].bounds = bounds;
+
+	int axis = -1, split = 0;
+	bool spatial = false;
+	if(depth < BVH_STACK_SIZE - 2 && count > 1)
+	{
+		float overlap;
+		float cost = FindObjectSplit(refs, centroidBounds, axis, split, overlap);
+		if(overlap > m_MinOverlap && m_NbRefs < m_MaxRefs)
+		{
+			int spatialAxis, spatialSplit;
+			float spatialCost = FindSpatialSplit(primBounds, refs, bounds, spatialAxis, spatialSplit);
+			if(spatialCost < cost)
+			{
+				cost = spatialCost;
+				axis = spatialAxis;
+				split = spatialSplit;
+				spatial = true;
+			}
+		}
+		// a node small enough to be a leaf is split only if it pays off
+		if(count <= maxLeafSize)
+		{
+			float area = bounds.GetArea();
+			if(!(area > 0) || BVH_TRAVERSAL_COST + m_IntersectionCost * cost / area
+				>= count * m_IntersectionCost)
+				axis = -1;
+		}
+	}
+
+	vector<BVHReference> left, right;
+	if(axis >= 0)
+	{
+		const Vector3 bmin = bounds.GetMin(), bsize = bounds.GetSize();
+		const Vector3 cmin = centroidBounds.GetMin(), csize = centroidBounds.GetSize();
+		const float min = spatial ? (&bmin.x)[axis] : (&cmin.x)[axis];
+		const float scale = BVH_BINS / (spatial ? (&bsize.x)[axis] : (&csize.x)[axis]);
+		const float pos = min + split / scale;
+		for(int i = 0; i < count; i++)
+		{
+			const BVHReference& ref = refs[i];
+			Vector3 rmin = ref.bounds.GetMin(), rmax = ref.bounds.GetMax();
+			Vector3 center = ref.bounds.GetCenter();
+			if(!spatial)
+			{
+				if(CentroidBinLess::GetBin((&center.x)[axis], min, scale) < split)
+					left.push_back(ref);
+				else
+					right.push_back(ref);
+				continue;
+			}
+
+			int first = CentroidBinLess::GetBin((&rmin.x)[axis], min, scale);
+			int last = CentroidBinLess::GetBin((&rmax.x)[axis], min, scale);
+			BVHReference l = ref, r = ref;
+			if(last < split)
+				r.bounds = Box();
+			else if(first >= split)
+				l.bounds = Box();
+			else if(m_NbRefs >= m_MaxRefs)
+			{
+				// no more duplication : the side of the center
+				if((&center.x)[axis] < pos)
+					r.bounds = Box();
+				else
+					l.bounds = Box();
+			}
+			else
+			{
+				Vector3 lmax = rmax, rmin2 = rmin;
+				(&lmax.x)[axis] = pos;
+				(&rmin2.x)[axis] = pos;
+				l.bounds = Clip(primBounds, ref, MakeBox(rmin, lmax));
+				r.bounds = Clip(primBounds, ref, MakeBox(rmin2, rmax));
+				if(::IsEmpty(l.bounds) && ::IsEmpty(r.bounds))
+					r.bounds = ref.bounds;
+				else if(!::IsEmpty(l.bounds) && !::IsEmpty(r.bounds))
+					m_NbRefs++;
+			}
+			if(!::IsEmpty(l.bounds))
+				left.push_back(l);
+			if(!::IsEmpty(r.bounds))
+				right.push_back(r);
+		}
+	}
+	if((left.empty() || right.empty()) && count > maxLeafSize && depth < BVH_STACK_SIZE - 2)
+	{
+		// no split found : halves along the largest axis of the centroids
+		Vector3 size = centroidBounds.GetSize();
+		int largest = 0;
+		if(size.y > size.x) largest = 1;
+		if(size.z > ((largest == 0) ? size.x : size.y)) largest = 2;
+		std::nth_element(refs.begin(), refs.begin() + count / 2, refs.end(), ReferenceLess(largest));
+		left.assign(refs.begin(), refs.begin() + count / 2);
+		right.assign(refs.begin() + count / 2, refs.end());
+	}
+	if(left.empty() || right.empty())
+	{
+		m_Nodes[index].first = (int)m_Indices.size();
+		m_Nodes[index].count = count;
+		for(int i = 0; i < count; i++)
+			m_Indices.push_back(refs[i].prim);
+		return index;
+	}
+
+	vector<BVHReference>().swap(refs);
+	BuildSpatialNode(primBounds, left, maxLeafSize, depth + 1);
+	int second = BuildSpatialNode(primBounds, right, maxLeafSize, depth + 1);
+	m_Nodes[index].first = second;
+	m_Nodes[index].count = 0;
+	return index;
+}
+
+/**
+ * Finds the best object split of the references (binned SAH on the centers
+ * of their bounds).
+ * @param axis, split axis and first bin of the second child, axis is -1 if the
+ * references can't be split.
+ * @param overlap receives the area of the overlap of the children.
+ * @return the cost of the split (see SweepBins).
+ */
+float BVH::FindObjectSplit(const vector<BVHReference>& refs, const Box& centroidBounds,
+	int& axis, int& split, float& overlap) const
+{
+	const Vector3 cmin = centroidBounds.GetMin(), size = centroidBounds.GetSize();
+	const float* min = &cmin.x;
+	const float* extent = &size.x;
+	float bestCost = std::numeric_limits<float>::infinity();
+	axis = -1;
+	overlap = 0;
+	for(int a = 0; a < 3; a++)
+	{
+		if(!(extent[a] > 0))
+			continue;
+		const float scale = BVH_BINS / extent[a];
+		Box binBounds[BVH_BINS];
+		int binCounts[BVH_BINS] = {0};
+		for(size_t i = 0; i < refs.size(); i++)
+		{
+			Vector3 center = refs[i].bounds.GetCenter();
+			int bin = CentroidBinLess::GetBin((&center.x)[a], min[a], scale);
+			binCounts[bin]++;
+			binBounds[bin].Extend(refs[i].bounds);
+		}
+		if(SweepBins(binBounds, binCounts, binCounts, bestCost, split))
+			axis = a;
+	}
+	if(axis < 0)
+		return bestCost;
+
+	Box left, right;
+	const float scale = BVH_BINS / extent[axis];
+	for(size_t i = 0; i < refs.size(); i++)
+	{
+		Vector3 center = refs[i].bounds.GetCenter();
+		if(CentroidBinLess::GetBin((&center.x)[axis], min[axis], scale) < split)
+			left.Extend(refs[i].bounds);
+		else
+			right.Extend(refs[i].bounds);
+	}
+	Box common = Intersection(left, right);
+	if(!::IsEmpty(common))
+		overlap = common.GetArea();
+	return bestCost;
+}
+
+/**
+ * Finds the best spatial split of the node : its bounds are divided in
+ * BVH_BINS bins along each axis, and each reference is clipped to the bins it
+ * crosses.
+ * @param axis, split axis and first bin of the second child (axis is -1 if no
+ * split was found).
+ * @return the cost of the split (see SweepBins).
+ */
+float BVH::FindSpatialSplit(const vector<Box>& primBounds, const vector<BVHReference>& refs,
+	const Box& bounds, int& axis, int& split) const
+{
+	const Vector3 bmin = bounds.GetMin(), size = bounds.GetSize();
+	const float* min = &bmin.x;
+	const float* extent = &size.x;
+	float bestCost = std::numeric_limits<float>::infinity();
+	axis = -1;
+	for(int a = 0; a < 3; a++)
+	{
+		if(!(extent[a] > 0))
+			continue;
+		const float scale = BVH_BINS / extent[a];
+		Box binBounds[BVH_BINS];
+		int entries[BVH_BINS] = {0}, exits[BVH_BINS] = {0};
+		for(size_t i = 0; i < refs.size(); i++)
+		{
+			const BVHReference& ref = refs[i];
+			Vector3 rmin = ref.bounds.GetMin(), rmax = ref.bounds.GetMax();
+			int first = CentroidBinLess::GetBin((&rmin.x)[a], min[a], scale);
+			int last = CentroidBinLess::GetBin((&rmax.x)[a], min[a], scale);
+			entries[first]++;
+			exits[last]++;
+			if(first == last)
+			{
+				binBounds[first].Extend(ref.bounds);
+				continue;
+			}
+			for(int bin = first; bin <= last; bin++)
+			{
+				Vector3 lo = rmin, hi = rmax;
+				if(bin > first)
+					(&lo.x)[a] = min[a] + bin / scale;
+				if(bin < last)
+					(&hi.x)[a] = min[a] + (bin + 1) / scale;
+				Box part = Clip(primBounds, ref, MakeBox(lo, hi));
+				if(!::IsEmpty(part))
+					binBounds[bin].Extend(part);
+			}
+		}
+		if(SweepBins(binBounds, entries, exits, bestCost, split))
+			axis = a;
+	}
+	return bestCost;
+}
+
+/**
+ * @return the bounds of the part of the primitive of ref inside box.
+ */
+Box BVH::Clip(const vector<Box>& primBounds, const BVHReference& ref, const Box& box) const
+{
+	Box part = Intersection(Intersection(primBounds[ref.prim], ref.bounds), box);
+	if(m_Clipper && !::IsEmpty(part))
+		part = Intersection(m_Clipper->Clip(ref.prim, part), part);
+	return part;
+}
+
+//------------------------------------------------------------------- FUNCTIONS
+
+/**
+ * @return the bounds of the part of the triangle ABC inside box (empty if the
+ * triangle doesn't cross the box). The triangle is clipped by the 6 planes of
+ * the box (Sutherland-Hodgman), which adds at most one vertex each.
+ */
+Box ClipTriangle(const Vector3& A, const Vector3& B, const Vector3& C, const Box& box)
+{
+	Vector3 polygons[2][9];
+	polygons[0][0] = A;
+	polygons[0][1] = B;
+	polygons[0][2] = C;
+	int nbVertices = 3;
+	int current = 0;
+	const Vector3 bmin = box.GetMin(), bmax = box.GetMax();
+	for(int plane = 0; plane < 6 && nbVertices > 0; plane++)
+	{
+		const int axis = plane % 3;
+		const bool upper = plane >= 3;
+		const float bound = upper ? (&bmax.x)[axis] : (&bmin.x)[axis];
+		const Vector3* in = polygons[current];
+		Vector3* out = polygons[1 - current];
+		int nbOut = 0;
+		for(int i = 0; i < nbVertices; i++)
+		{
+			const Vector3& p = in[i];
+			const Vector3& q = in[(i + 1) % nbVertices];
+			// positive inside the box
+			float dp = upper ? bound - (&p.x)[axis] : (&p.x)[axis] - bound;
+			float dq = upper ? bound - (&q.x)[axis] : (&q.x)[axis] - bound;
+			if(dp >= 0)
+				out[nbOut++] = p;
+			if((dp >= 0) != (dq >= 0))
+			{
+				Vector3 v = p + (q - p) * (dp / (dp - dq));
+				(&v.x)[axis] = bound;
+				out[nbOut++] = v;
+			}
+		}
+		nbVertices = nbOut;
+		current = 1 - current;
+	}
+
+	Box bounds;
+	for(int i = 0; i < nbVertices; i++)
+		bounds.Extend(polygons[current][i]);
+	return Intersection(bounds, box);
+}
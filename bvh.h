@@ -0,0 +1,273 @@
+/**
+* File : bvh.h
+* Description : Bounding volume hierarchy built over a set of primitives.
+* The hierarchy only knows the bounding boxes of the primitives : the leaves
+* reference ranges of an array of primitive indices and the intersection of
+* the primitives themselves is left to the caller (see BVH::Intersect).
+* The nodes are split with the surface area heuristic (SAH) evaluated on a
+* few bins along each axis, or by the Morton codes of the primitives for the
+* fast rebuilds of dynamic scenes, or with spatial splits duplicating the
+* long primitives straddling the split planes (see SetSplitMethod). When the
+* primitives move, the hierarchy can be refitted (same tree, new bounds)
+* instead of being built again ; its SAH cost tells how much the tree has
+* degraded since the build (see GetDegradation).
+* The subtrees of the top levels of the large hierarchies, the binning and the
+* partition of their large nodes, the Morton sort and the refit are split
+* between several threads (see BVH_PARALLEL_SIZE).
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef BVH_H
+#define BVH_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "rtObjects.h"
+
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------- CONSTS
+
+// maximum depth of the hierarchy (size of the traversal stack)
+#define BVH_STACK_SIZE 64
+
+// costs of the surface area heuristic (see BVH::GetCost) : the traversal of a
+// node, and by default the intersection of a primitive, measured for the
+// triangles of the meshes (see BVH::SetIntersectionCost)
+#define BVH_TRAVERSAL_COST 1.0f
+#define BVH_INTERSECTION_COST 1.0f
+
+// number of bins along each axis in which the splits are evaluated
+#define BVH_BINS 16
+
+// the children of a node are built by two threads when both have at least
+// BVH_PARALLEL_SIZE primitives, with at most BVH_BUILD_THREADS subtrees built
+// at the same time. The passes over the primitives of the large nodes are
+// split between the threads left, each with at least BVH_PARALLEL_SIZE
+// primitives. The Morton sorts of at least BVH_PARALLEL_SIZE primitives are
+// split between BVH_BUILD_THREADS threads, and so are the refits of the
+// subtrees of at least BVH_PARALLEL_SIZE nodes.
+#define BVH_PARALLEL_SIZE 16384
+#define BVH_BUILD_THREADS 8
+
+// bits of a Morton code per axis (30 bits codes)
+#define BVH_MORTON_BITS 10
+
+// maximum number of primitives of the subtrees built again with the SAH
+// after a Morton build (see BVH_SPLIT_MORTON_SAH)
+#define BVH_TREELET_SIZE 16
+
+// spatial splits are only tried when the children of the best object split
+// overlap by more than this fraction of the area of the root
+#define BVH_SPATIAL_OVERLAP 1e-5f
+
+// default number of references added by the spatial splits, relative to the
+// number of primitives (see BVH::SetMaxDuplication)
+#define BVH_MAX_DUPLICATION 0.5f
+
+// default degradation (see BVH::GetDegradation) above which a refitted
+// hierarchy should be built again
+#define BVH_MAX_DEGRADATION 1.5f
+
+//----------------------------------------------------------------------- TYPES
+
+enum BVHSplit
+{
+	BVH_SPLIT_MEDIAN = 0, // halves along the largest axis of the centroids
+	BVH_SPLIT_SAH, // binned surface area heuristic
+	// linear BVH : the primitives are sorted along a Morton curve and split at
+	// the highest bit that differs in their codes (fastest build)
+	BVH_SPLIT_MORTON,
+	// same for the top levels, the subtrees of at most BVH_TREELET_SIZE
+	// primitives being built with the SAH
+	BVH_SPLIT_MORTON_SAH,
+	// binned SAH choosing between the object splits and the spatial splits,
+	// which clip the primitives straddling the split plane and reference
+	// them from both children (SBVH). A primitive may then appear in several
+	// leaves.
+	BVH_SPLIT_SPATIAL
+};
+
+// ----------------------------------------------------------------------------
+// Primitive reordered by the object splits of a build. Its bounds and its
+// centroid are moved with it, so the passes over the primitives of a node
+// read contiguous memory.
+// ----------------------------------------------------------------------------
+
+struct BVHPrimitive
+{
+	Box bounds;
+	Vector3 centroid;
+	int prim;
+};
+
+// ----------------------------------------------------------------------------
+// Part of a primitive referenced by a node during a spatial split build
+// ----------------------------------------------------------------------------
+
+struct BVHReference
+{
+	int prim;
+	Box bounds; // bounds of the part of the primitive inside the node
+};
+
+// ----------------------------------------------------------------------------
+// Clips the primitives for the spatial splits. The default clipper only
+// knows the bounding boxes of the primitives.
+// ----------------------------------------------------------------------------
+
+class BVHClipper
+{
+public:
+	virtual ~BVHClipper() {}
+	/**
+	 * @return the bounds of the part of the primitive prim inside box (empty
+	 * if the primitive doesn't cross the box).
+	 */
+	virtual Box Clip(int prim, const Box& box) const = 0;
+};
+
+// ----------------------------------------------------------------------------
+// Node of the hierarchy. The first child of an inner node is stored right
+// after it, so only the index of the second child is kept.
+// ----------------------------------------------------------------------------
+
+struct BVHNode
+{
+	Box bounds;
+	int first; // leaf : index of the first primitive, inner node : second child
+	int count; // number of primitives of a leaf (0 for an inner node)
+};
+
+//----------------------------------------------------------------------- CLASS
+
+// ----------------------------------------------------------------------------
+// BVH class
+// ----------------------------------------------------------------------------
+
+class BVH
+{
+public:
+	BVH():m_BuildCost(0),m_Split(BVH_SPLIT_SAH),m_Clipper(0),
+		m_MaxDuplication(BVH_MAX_DUPLICATION),m_IntersectionCost(BVH_INTERSECTION_COST){}
+
+	void Build(const vector<Box>& primBounds, int maxLeafSize);
+	void Refit(const vector<Box>& primBounds);
+	void Clear() { m_Nodes.clear(); m_Indices.clear(); m_BuildCost = 0; }
+
+	BVHSplit GetSplitMethod() const { return m_Split; }
+	void SetSplitMethod(BVHSplit split) { m_Split = split; }
+	// clipper of the primitives used by BVH_SPLIT_SPATIAL (not owned)
+	void SetClipper(const BVHClipper* clipper) { m_Clipper = clipper; }
+	float GetMaxDuplication() const { return m_MaxDuplication; }
+	void SetMaxDuplication(float duplication) { m_MaxDuplication = duplication; }
+	// cost of the intersection of a primitive relative to the traversal of a
+	// node : the cheaper the primitives, the more of them in each leaf
+	float GetIntersectionCost() const { return m_IntersectionCost; }
+	void SetIntersectionCost(float cost) { m_IntersectionCost = cost; }
+	float GetCost() const;
+	// ratio between the current cost and the cost after the last build
+	float GetDegradation() const { return m_BuildCost > 0 ? GetCost() / m_BuildCost : 1.0f; }
+
+	bool IsEmpty() const { return m_Nodes.empty(); }
+	const vector<BVHNode>& GetNodes() const { return m_Nodes; }
+	// primitive referenced by each entry of the leaves (a primitive can be
+	// referenced several times after a spatial split build)
+	const vector<int>& GetIndices() const { return m_Indices; }
+	Box GetBounds() const { return m_Nodes.empty() ? Box() : m_Nodes[0].bounds; }
+
+	template <class LeafTest>
+	float Intersect(const Ray& ray, LeafTest& test,
+		float tmax = std::numeric_limits<float>::infinity()) const;
+
+private:
+	struct BuildTask; // subtree built by a thread (see BuildSubtree)
+	struct RefitTask; // subtree refitted by a thread (see RefitSubtree)
+
+	int BuildNode(vector<BVHNode>& nodes, vector<BVHPrimitive>& prims, int begin, int end,
+		int maxLeafSize, int depth);
+	int BuildChildren(vector<BVHNode>& nodes, vector<BVHPrimitive>& prims,
+		const vector<unsigned int>* codes, int begin, int mid, int end, int maxLeafSize,
+		int depth);
+	static int BuildSubtree(void* task);
+	void SplitRefit(int index, int end, int depth, vector<int>& top, RefitTask tasks[],
+		int& nbTasks);
+	void RefitNodes(const vector<Box>& primBounds, int begin, int end);
+	static int RefitSubtree(void* task);
+	int SplitSAH(vector<BVHPrimitive>& prims, int begin, int end, const Box& bounds,
+		const Box& centroidBounds, int maxLeafSize, int depth) const;
+	int SplitMedian(vector<BVHPrimitive>& prims, int begin, int end,
+		const Box& centroidBounds);
+	void SortMorton(vector<BVHPrimitive>& prims, vector<unsigned int>& codes);
+	int BuildMortonNode(vector<BVHNode>& nodes, vector<BVHPrimitive>& prims,
+		const vector<unsigned int>& codes, int begin, int end, int maxLeafSize, int depth);
+	int BuildSpatialNode(const vector<Box>& primBounds, vector<BVHReference>& refs,
+		int maxLeafSize, int depth);
+	float FindObjectSplit(const vector<BVHReference>& refs, const Box& centroidBounds,
+		int& axis, int& split, float& overlap) const;
+	float FindSpatialSplit(const vector<Box>& primBounds, const vector<BVHReference>& refs,
+		const Box& bounds, int& axis, int& split) const;
+	Box Clip(const vector<Box>& primBounds, const BVHReference& ref, const Box& box) const;
+
+	vector<BVHNode> m_Nodes;
+	vector<int> m_Indices;
+	float m_BuildCost; // cost of the hierarchy after the last build
+	BVHSplit m_Split;
+	const BVHClipper* m_Clipper;
+	float m_MaxDuplication;
+	float m_IntersectionCost;
+	// state of a spatial split build
+	int m_NbRefs, m_MaxRefs;
+	float m_MinOverlap;
+};
+
+//------------------------------------------------------------------- FUNCTIONS
+
+Box ClipTriangle(const Vector3& A, const Vector3& B, const Vector3& C, const Box& box);
+
+//--------------------------------------------------------------------- INLINES
+
+/**
+ * Finds the nearest intersection between the ray and the primitives of the
+ * hierarchy.
+ * @param test functor called for each leaf hit by the ray :
+ * float test(int first, int count, const Ray& ray) returns the distance to the
+ * nearest primitive of the leaf (first is an index in GetIndices()).
+ * @param tmax the nodes farther than tmax are skipped.
+ * @return tmax if no nearer intersection detected.
+ */
+template <class LeafTest>
+float BVH::Intersect(const Ray& ray, LeafTest& test, float tmax) const
+{
+	float nearest = tmax;
+	if(m_Nodes.empty())
+		return nearest;
+
+	int stack[BVH_STACK_SIZE];
+	int nbNodes = 0;
+	stack[nbNodes++] = 0;
+	while(nbNodes > 0)
+	{
+		const BVHNode& node = m_Nodes[stack[--nbNodes]];
+		float tnear, tfar;
+		if(!node.bounds.Intersect(ray, 0, nearest, tnear, tfar))
+			continue;
+		if(node.count > 0)
+		{
+			float dist = test(node.first, node.count, ray);
+			if(dist < nearest)
+				nearest = dist;
+		}
+		else
+		{
+			stack[nbNodes++] = node.first;
+			stack[nbNodes++] = (int)(&node - &m_Nodes[0]) + 1;
+		}
+	}
+	return nearest;
+}
+
+#endif // BVH_H
@@ -0,0 +1,123 @@
+/**
+* File : camera.cpp
+* Description : Point of view of a render.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "camera.h"
+
+//--------------------------------------------------------------------- METHODS
+
+/**
+ * The default camera looks along the z axis from (0, 2, -10).
+ */
+Camera::Camera():m_Position(0, 2, -10),m_FOV(CAMERA_FOV),m_Aspect(CAMERA_ASPECT),
+	m_ShiftX(0),m_ShiftY(CAMERA_SHIFT_Y),m_Width(SCR_WIDTH),m_Height(SCR_HEIGHT)
+{
+	m_Orientation.identity();
+	Update();
+}
+
+void Camera::SetOrientation(const Mat4x4& orientation)
+{
+	m_Orientation = orientation;
+	Update();
+}
+
+/**
+ * Orients the camera towards a point.
+ * @param up direction of the top of the image (projected on the plane
+ * orthogonal to the direction of the target).
+ */
+void Camera::LookAt(const Vector3& target, const Vector3& up)
+{
+	Vector3 forward = target - m_Position;
+	forward.Normalize();
+	Vector3 right = Cross(up, forward);
+	right.Normalize();
+	Vector3 top = Cross(forward, right);
+
+	Mat4x4 orientation(right.x, right.y, right.z, 0,
+		top.x, top.y, top.z, 0,
+		forward.x, forward.y, forward.z, 0,
+		0, 0, 0, 1);
+	SetOrientation(orientation);
+}
+
+void Camera::SetFOV(float fov)
+{
+	m_FOV = fov;
+	Update();
+}
+
+void Camera::SetAspect(float aspect)
+{
+	m_Aspect = aspect;
+	Update();
+}
+
+void Camera::SetShift(float x, float y)
+{
+	m_ShiftX = x;
+	m_ShiftY = y;
+	Update();
+}
+
+/**
+ * Sets the resolution of the frames rendered with this camera.
+ */
+void Camera::SetResolution(int width, int height)
+{
+	if(width == m_Width && height == m_Height)
+		return;
+	m_Width = width;
+	m_Height = height;
+	Update();
+}
+
+/**
+ * Finds the point of the frame through which a point of the scene is seen
+ * (inverse of GetDirection).
+ * @param x, y receive the position of the point in the frame, in pixels.
+ * @return false if the point is behind the camera.
+ */
+bool Camera::Project(const Vector3& point, float& x, float& y) const
+{
+	Vector3 d = point - m_Position;
+	float z = Dot(d, m_Forward);
+	if(z <= 0)
+		return false;
+	float invZ = 1.0f / z;
+	x = (Dot(d, m_Right) * invZ - m_U0) / m_DU;
+	y = (Dot(d, m_Up) * invZ - m_V0) / m_DV;
+	return true;
+}
+
+/**
+ * Computes the terms of the directions of the primary rays.
+ */
+void Camera::Update()
+{
+	m_Right = Vector3(m_Orientation._11, m_Orientation._12, m_Orientation._13);
+	m_Up = Vector3(m_Orientation._21, m_Orientation._22, m_Orientation._23);
+	m_Forward = Vector3(m_Orientation._31, m_Orientation._32, m_Orientation._33);
+
+	// half size of the screen
+	float halfWidth = tanf(m_FOV * 0.5f * (float)RAD);
+	float halfHeight = halfWidth / m_Aspect;
+	m_DU = 2.0f * halfWidth / m_Width;
+	m_DV = -2.0f * halfHeight / m_Height;
+	m_U0 = halfWidth * (m_ShiftX - 1.0f) + 0.5f * m_DU;
+	m_V0 = halfHeight * (m_ShiftY + 1.0f) + 0.5f * m_DV;
+
+	m_Columns.resize(2 * m_Width + 1);
+	for(int X = -1; X < 2 * m_Width; X++)
+		m_Columns[X + 1] = m_Right * (m_U0 + X * 0.5f * m_DU);
+	m_Lines.resize(2 * m_Height + 1);
+	for(int Y = -1; Y < 2 * m_Height; Y++)
+		m_Lines[Y + 1] = m_Forward + m_Up * (m_V0 + Y * 0.5f * m_DV);
+}
@@ -0,0 +1,107 @@
+/**
+* File : camera.h
+* Description : Point of view of a render. The camera is placed at a position
+* and oriented by a matrix whose rows are its right, up and forward axes (in
+* world space, see Mat4x4). The field of view is the horizontal angle seen by
+* the camera, the aspect ratio is the ratio between the width and the height
+* of the image. The image can be shifted on the screen (off-axis projection)
+* so that the forward axis doesn't go through its center.
+* The directions of the primary rays are split into a term depending on the
+* column of the pixel and a term depending on its line, precomputed for the
+* centers, edges and corners of the pixels (the lattice of the SampleCache) :
+* the direction of such a point is the sum of two vectors. The terms are only
+* recomputed when the camera or the resolution of the frame change.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef CAMERA_H
+#define CAMERA_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "defs.h"
+#include "Maths/math3D.h"
+
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------- CONSTS
+
+// default camera : a screen of 8 x 6 units, 10 units in front of the eye and
+// centered 2 units below it
+#define CAMERA_FOV 43.6028f // horizontal field of view in degrees
+#define CAMERA_ASPECT (4.0f / 3.0f)
+#define CAMERA_SHIFT_Y (-2.0f / 3.0f)
+
+//----------------------------------------------------------------------- CLASS
+
+// ----------------------------------------------------------------------------
+// Camera class
+// ----------------------------------------------------------------------------
+
+class Camera
+{
+public:
+	Camera();
+
+	const Vector3& GetPosition() const { return m_Position; }
+	void SetPosition(const Vector3& position) { m_Position = position; }
+	const Mat4x4& GetOrientation() const { return m_Orientation; }
+	void SetOrientation(const Mat4x4& orientation);
+	void LookAt(const Vector3& target, const Vector3& up = Vector3(0, 1, 0));
+	float GetFOV() const { return m_FOV; }
+	void SetFOV(float fov);
+	float GetAspect() const { return m_Aspect; }
+	void SetAspect(float aspect);
+	/**
+	 * Offset of the center of the image, in half sizes of the image.
+	 */
+	float GetShiftX() const { return m_ShiftX; }
+	float GetShiftY() const { return m_ShiftY; }
+	void SetShift(float x, float y);
+
+	void SetResolution(int width, int height);
+
+	/**
+	 * @return the direction (not normalized) of the ray fired through the
+	 * point (x, y) of the frame, in pixels (the point (x, y) is the center of
+	 * the pixel (x, y)).
+	 */
+	Vector3 GetDirection(float x, float y) const
+	{
+		return m_Forward + m_Right * (m_U0 + x * m_DU) + m_Up * (m_V0 + y * m_DV);
+	}
+
+	/**
+	 * Same as GetDirection for the point (X / 2, Y / 2) of the frame, with
+	 * -1 <= X <= 2 * width - 1 and -1 <= Y <= 2 * height - 1.
+	 */
+	Vector3 GetLatticeDirection(int X, int Y) const
+	{
+		return m_Columns[X + 1] + m_Lines[Y + 1];
+	}
+
+	bool Project(const Vector3& point, float& x, float& y) const;
+
+private:
+	void Update();
+
+	Vector3 m_Position;
+	Mat4x4 m_Orientation;
+	float m_FOV, m_Aspect;
+	float m_ShiftX, m_ShiftY;
+	int m_Width, m_Height; // resolution of the frame
+
+	// axes of the camera, taken from the orientation
+	Vector3 m_Right, m_Up, m_Forward;
+	// screen coordinates of the center of the pixel (0, 0) and size of a pixel,
+	// the screen being at a distance of 1 from the camera
+	float m_U0, m_V0, m_DU, m_DV;
+	// terms of the directions of the lattice
+	vector<Vector3> m_Columns; // right * u
+	vector<Vector3> m_Lines; // forward + up * v
+};
+
+#endif // CAMERA_H
@@ -0,0 +1,181 @@
+/**
+* File : edgeFilter.cpp
+* Description : Anti-aliasing applied to the final colors of a frame.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "edgeFilter.h"
+#include "kernels.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+//--------------------------------------------------------------------- METHODS
+
+/**
+ * Filters the final colors of a frame. The lumas are those of the colors
+ * before the filter : the new colors are written at the end.
+ */
+void EdgeFilter::Apply(FrameBuffer& frame)
+{
+	const KernelTable& kernels = GetKernels();
+	m_Width = frame.GetWidth();
+	m_Height = frame.GetHeight();
+	const int stride = m_Width + 2;
+	m_Luma.resize(stride * (m_Height + 2));
+	m_Edges.resize(m_Width);
+	m_Pixels.clear();
+	m_Colors.clear();
+
+	for(int y = 0; y < m_Height; y++)
+	{
+		float* line = &m_Luma[(y + 1) * stride];
+		int i = y * m_Width;
+		kernels.ComputeLuma(frame.GetRed() + i, frame.GetGreen() + i, frame.GetBlue() + i,
+			m_Width, line + 1);
+		line[0] = line[1];
+		line[m_Width + 1] = line[m_Width];
+	}
+	memcpy(&m_Luma[0], &m_Luma[stride], stride * sizeof(float));
+	memcpy(&m_Luma[(m_Height + 1) * stride], &m_Luma[m_Height * stride], stride * sizeof(float));
+
+	for(int y = 0; y < m_Height; y++)
+	{
+		const float* line = &m_Luma[(y + 1) * stride + 1];
+		int nbEdges = kernels.FindEdges(line - stride, line, line + stride, m_Width,
+			EDGE_MIN_CONTRAST, EDGE_REL_CONTRAST, &m_Edges[0]);
+		for(int i = 0; i < nbEdges; i++)
+		{
+			int x = m_Edges[i];
+			if(m_ObjectGuided && !IsObjectBorder(frame, x, y))
+				continue;
+
+			Color color;
+			if(FilterPixel(frame, x, y, color))
+			{
+				m_Pixels.push_back(x + y * m_Width);
+				m_Colors.push_back(color);
+			}
+		}
+	}
+
+	for(size_t i = 0; i < m_Pixels.size(); i++)
+		frame.SetColor(m_Pixels[i] % m_Width, m_Pixels[i] / m_Width, m_Colors[i]);
+}
+
+/**
+ * @return true if the object of the pixel (x, y) differs from the object of
+ * one of its 4 neighbors.
+ */
+bool EdgeFilter::IsObjectBorder(const FrameBuffer& frame, int x, int y) const
+{
+	RTObject* object = frame.GetObject(x, y);
+	return (x > 0 && frame.GetObject(x - 1, y) != object) ||
+		(x < m_Width - 1 && frame.GetObject(x + 1, y) != object) ||
+		(y > 0 && frame.GetObject(x, y - 1) != object) ||
+		(y < m_Height - 1 && frame.GetObject(x, y + 1) != object);
+}
+
+/**
+ * Follows an edge from a pixel until the average luma of the pixels on both
+ * sides of the edge differs from lumaEdge by more than gradient.
+ * @param luma luma of the pixel.
+ * @param step offset between two pixels along the edge in m_Luma.
+ * @param side offset of the pixel on the other side of the edge in m_Luma.
+ * @param maxSteps number of pixels before the border of m_Luma : beyond it,
+ * the lumas are those of the border and the end can't be found anymore.
+ * @param lumaEnd receives the difference of luma found at the end.
+ * @return the distance between the pixel and the end of the edge.
+ */
+int EdgeFilter::FindEnd(const float* luma, int step, int side, int maxSteps,
+	float lumaEdge, float gradient, float& lumaEnd) const
+{
+	int nbSteps = std::min(maxSteps + 1, EDGE_SEARCH_STEPS);
+	for(int i = 1; i < nbSteps; i++)
+	{
+		const float* l = luma + i * step;
+		lumaEnd = 0.5f * (l[0] + l[side]) - lumaEdge;
+		if(fabsf(lumaEnd) >= gradient)
+			return i;
+	}
+	return EDGE_SEARCH_STEPS;
+}
+
+/**
+ * Computes the filtered color of a pixel found by the kernels.
+ * @return false if the color of the pixel doesn't change.
+ */
+bool EdgeFilter::FilterPixel(const FrameBuffer& frame, int x, int y, Color& color) const
+{
+	const int stride = m_Width + 2;
+	const float* luma = GetLuma(x, y);
+	float lumaM = luma[0];
+	float lumaN = luma[-stride];
+	float lumaS = luma[stride];
+	float lumaW = luma[-1];
+	float lumaE = luma[1];
+	float lumaNW = luma[-stride - 1];
+	float lumaNE = luma[-stride + 1];
+	float lumaSW = luma[stride - 1];
+	float lumaSE = luma[stride + 1];
+
+	float lumaMax = MaxF(MaxF(MaxF(lumaN, lumaS), MaxF(lumaW, lumaE)), lumaM);
+	float lumaMin = MinF(MinF(MinF(lumaN, lumaS), MinF(lumaW, lumaE)), lumaM);
+	float range = lumaMax - lumaMin;
+
+	// blending of the isolated pixels : contrast between the pixel and the
+	// average of its neighbors
+	float average = (2.0f * (lumaN + lumaS + lumaW + lumaE) + lumaNW + lumaNE + lumaSW + lumaSE)
+		* (1.0f / 12.0f);
+	float subpixel = MinF(fabsf(average - lumaM) / range, 1.0f);
+	subpixel = (3.0f - 2.0f * subpixel) * subpixel * subpixel;
+	subpixel = subpixel * subpixel * EDGE_SUBPIXEL;
+
+	// the edge is horizontal if the lumas vary more between the lines than
+	// between the columns
+	float edgeHorz = 2.0f * fabsf(lumaN + lumaS - 2.0f * lumaM) +
+		fabsf(lumaNW + lumaSW - 2.0f * lumaW) + fabsf(lumaNE + lumaSE - 2.0f * lumaE);
+	float edgeVert = 2.0f * fabsf(lumaW + lumaE - 2.0f * lumaM) +
+		fabsf(lumaNW + lumaNE - 2.0f * lumaN) + fabsf(lumaSW + lumaSE - 2.0f * lumaS);
+	bool horizontal = edgeHorz >= edgeVert;
+
+	// the pixel across the edge is on the side of the steepest gradient
+	float luma1 = horizontal ? lumaN : lumaW;
+	float luma2 = horizontal ? lumaS : lumaE;
+	float gradient1 = fabsf(luma1 - lumaM);
+	float gradient2 = fabsf(luma2 - lumaM);
+	int side = (gradient1 >= gradient2) ? -1 : 1;
+	float lumaEdge = 0.5f * (((side < 0) ? luma1 : luma2) + lumaM);
+	float gradient = 0.25f * MaxF(gradient1, gradient2);
+
+	// the edge is followed on the lines between the pixel and the pixel
+	// (sx, sy) across it
+	int sx = horizontal ? 0 : side, sy = horizontal ? side : 0;
+	int step = horizontal ? 1 : stride;
+	int offset = sx + sy * stride;
+	float lumaEnd1 = 0, lumaEnd2 = 0;
+	int dist1 = FindEnd(luma, -step, offset, horizontal ? x + 1 : y + 1,
+		lumaEdge, gradient, lumaEnd1);
+	int dist2 = FindEnd(luma, step, offset, horizontal ? m_Width - x : m_Height - y,
+		lumaEdge, gradient, lumaEnd2);
+
+	// the nearest end tells whether the pixel lies on the side of the edge
+	// that must be blended
+	float lumaEnd = (dist1 < dist2) ? lumaEnd1 : lumaEnd2;
+	float blend = 0;
+	if((lumaEnd < 0) != (lumaM < lumaEdge))
+		blend = 0.5f - (float)std::min(dist1, dist2) / (dist1 + dist2);
+	blend = MaxF(blend, subpixel);
+	if(blend <= 0)
+		return false;
+
+	int nx = std::min(std::max(x + sx, 0), m_Width - 1);
+	int ny = std::min(std::max(y + sy, 0), m_Height - 1);
+	color = frame.GetColor(x, y) * (1.0f - blend) + frame.GetColor(nx, ny) * blend;
+	return true;
+}
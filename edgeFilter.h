@@ -0,0 +1,80 @@
+/**
+* File : edgeFilter.h
+* Description : Anti-aliasing applied to the final colors of a frame instead
+* of tracing more rays (in the spirit of FXAA by T. Lottes). The pixels whose
+* luma contrasts with their neighbors are found by the kernels (see
+* kernels.h). For each one, the direction of the edge is estimated, the edge
+* is followed in both directions to find its ends, and the pixel is blended
+* with the neighbor across the edge according to its position along it.
+* The filter can be restricted to the borders of the objects so that the
+* highlights and the textures inside an object are not blurred.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef EDGEFILTER_H
+#define EDGEFILTER_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "frameBuffer.h"
+
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------- CONSTS
+
+// minimum contrast (difference of luma) of a filtered pixel
+#define EDGE_MIN_CONTRAST 0.0312f
+// minimum contrast relative to the brightest luma around the pixel
+#define EDGE_REL_CONTRAST 0.125f
+// maximum number of pixels visited on each side when searching the ends
+// of an edge
+#define EDGE_SEARCH_STEPS 16
+// strength of the blending of the isolated pixels (1 = full)
+#define EDGE_SUBPIXEL 0.75f
+
+//----------------------------------------------------------------------- CLASS
+
+// ----------------------------------------------------------------------------
+// EdgeFilter class
+// ----------------------------------------------------------------------------
+
+class EdgeFilter
+{
+public:
+	EdgeFilter():m_Width(0),m_Height(0),m_ObjectGuided(false){}
+
+	/**
+	 * Only filters the pixels whose object differs from the object of a
+	 * neighbor (see FrameBuffer::GetObject).
+	 */
+	bool GetObjectGuided() const { return m_ObjectGuided; }
+	void SetObjectGuided(bool guided) { m_ObjectGuided = guided; }
+
+	void Apply(FrameBuffer& frame);
+
+private:
+	// luma of the pixel (x, y), the border of m_Luma can be read
+	const float* GetLuma(int x, int y) const
+	{
+		return &m_Luma[(x + 1) + (y + 1) * (m_Width + 2)];
+	}
+
+	int FindEnd(const float* luma, int step, int side, int maxSteps, float lumaEdge,
+		float gradient, float& lumaEnd) const;
+	bool IsObjectBorder(const FrameBuffer& frame, int x, int y) const;
+	bool FilterPixel(const FrameBuffer& frame, int x, int y, Color& color) const;
+
+	int m_Width, m_Height;
+	bool m_ObjectGuided;
+	// lumas of the frame with a border of one pixel (copy of the nearest pixel)
+	vector<float> m_Luma;
+	vector<int> m_Edges; // pixels of a line found by the kernels
+	// new colors of the filtered pixels, written once all the pixels are filtered
+	vector<int> m_Pixels;
+	vector<Color> m_Colors;
+};
+
+#endif // EDGEFILTER_H
@@ -0,0 +1,86 @@
+/**
+* File : frameBudget.cpp
+* Description : Controller keeping the render time of the frames under a
+* target.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "frameBudget.h"
+#include "rayTracer.h"
+
+//--------------------------------------------------------------------- GLOBALS
+
+// levels of quality, from the cheapest to the most expensive one
+static const QualityLevel s_Levels[] =
+{
+	// resolution, anti-aliasing, aa depth, ray depth
+	{0.25f, RENDER_NO_AA, 0, 1},
+	{0.375f, RENDER_NO_AA, 0, 1},
+	{0.5f, RENDER_NO_AA, 0, 2},
+	{0.625f, RENDER_POST_AA, 0, 2},
+	{0.75f, RENDER_POST_AA, 0, 3},
+	{0.875f, RENDER_POST_AA, 0, 3},
+	{1.0f, RENDER_POST_AA, 0, 3},
+	{1.0f, RENDER_ADAPTIVE_AA, 1, 3},
+	{1.0f, RENDER_ADAPTIVE_AA, 2, 3}
+};
+
+//--------------------------------------------------------------------- METHODS
+
+/**
+ * The controller is disabled by default. It starts at the cheapest level so
+ * that the first frames are on time.
+ */
+FrameBudget::FrameBudget():m_Target(0),m_Level(0),
+	m_Costs(sizeof(s_Levels) / sizeof(s_Levels[0]), -1.0f)
+{
+}
+
+const QualityLevel& FrameBudget::GetQuality() const
+{
+	return s_Levels[m_Level];
+}
+
+/**
+ * Selects the level of the next frame.
+ * @param frameTime render time in ms of the frame rendered at the current
+ * level.
+ */
+void FrameBudget::Update(float frameTime)
+{
+	// new cost of the current level, the other estimates follow it
+	float& cost = m_Costs[m_Level];
+	float newCost = (cost < 0) ? frameTime
+		: cost + FRAME_BUDGET_SMOOTHING * (frameTime - cost);
+	if(cost > 0)
+	{
+		float ratio = newCost / cost;
+		for(int i = 0; i < GetNbLevels(); i++)
+		{
+			if(i != m_Level && m_Costs[i] >= 0)
+				m_Costs[i] *= ratio;
+		}
+	}
+	cost = newCost;
+
+	if(frameTime > m_Target)
+	{
+		// too slow : at least one level down, more if the cost of the lower
+		// levels is known to exceed the target
+		int level = m_Level - 1;
+		while(level > 0 && m_Costs[level] > m_Target)
+			level--;
+		m_Level = (level < 0) ? 0 : level;
+	}
+	else if(m_Level + 1 < GetNbLevels())
+	{
+		// one level up if it is expected to fit in the target
+		float next = m_Costs[m_Level + 1];
+		if((next < 0) ? (frameTime < m_Target * FRAME_BUDGET_HEADROOM) : (next <= m_Target))
+			m_Level++;
+	}
+}
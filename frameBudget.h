@@ -0,0 +1,76 @@
+/**
+* File : frameBudget.h
+* Description : Controller keeping the render time of the frames under a
+* target. The quality of a frame is chosen among levels going from the
+* cheapest to the most expensive one : each level sets the resolution of the
+* frame (upscaled to the screen), the anti-aliasing and the maximum depth of
+* the ray tree. After each frame, the controller compares the measured time
+* to the target and selects the level of the next frame.
+* The cost of each level is estimated from the last time it was used, scaled
+* by the evolution of the cost of the current level : when the scene gets
+* cheaper or more expensive, all the estimates follow.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef FRAMEBUDGET_H
+#define FRAMEBUDGET_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------- CONSTS
+
+// default target render time of a frame in ms (see FrameBudget::SetTarget)
+#define FRAME_BUDGET_TARGET 33.0f
+// an unknown level is tried when the current frame takes less than this
+// fraction of the target
+#define FRAME_BUDGET_HEADROOM 0.7f
+// weight of a new measure in the estimated cost of a level
+#define FRAME_BUDGET_SMOOTHING 0.5f
+
+//----------------------------------------------------------------------- TYPES
+
+// Settings of the frames rendered at a level of quality
+struct QualityLevel
+{
+	float resolution; // size of the frame relative to the screen
+	int antiAliasing; // anti-aliasing mode (see RenderFlags)
+	int aaDepth; // depth of the adaptive anti-aliasing
+	int maxDepth; // maximum depth of the ray tree
+};
+
+//----------------------------------------------------------------------- CLASS
+
+// ----------------------------------------------------------------------------
+// FrameBudget class
+// ----------------------------------------------------------------------------
+
+class FrameBudget
+{
+public:
+	FrameBudget();
+
+	/**
+	 * Target render time of a frame in ms (0 disables the controller).
+	 */
+	float GetTarget() const { return m_Target; }
+	void SetTarget(float target) { m_Target = target; }
+	bool IsEnabled() const { return m_Target > 0; }
+
+	int GetNbLevels() const { return (int)m_Costs.size(); }
+	int GetLevel() const { return m_Level; }
+	const QualityLevel& GetQuality() const;
+
+	void Update(float frameTime);
+
+private:
+	float m_Target;
+	int m_Level; // level of the next frame
+	vector<float> m_Costs; // estimated render time of each level (< 0 if unknown)
+};
+
+#endif // FRAMEBUDGET_H
@@ -0,0 +1,181 @@
+/**
+* File : frameBuffer.cpp
+* Description : Buffers filled while rendering a frame.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "frameBuffer.h"
+#include "kernels.h"
+
+#include <algorithm>
+
+//--------------------------------------------------------------------- METHODS
+
+FrameBuffer::FrameBuffer(int width, int height):m_Width(0),m_Height(0),m_ObjectWords(1)
+{
+	Resize(width, height);
+}
+
+/**
+ * Changes the resolution of the frame (the content of the buffers and the
+ * record of the tiles are lost).
+ */
+void FrameBuffer::Resize(int width, int height)
+{
+	if(width == m_Width && height == m_Height)
+		return;
+
+	m_Width = width;
+	m_Height = height;
+	m_NbTilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	m_NbTilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+	int size = width * height;
+	m_Samples.resize(size);
+	m_Hits.assign(size, PrimaryHit());
+	m_Red.resize(size);
+	m_Green.resize(size);
+	m_Blue.resize(size);
+	m_TileObjects.assign(GetNbTiles() * m_ObjectWords, 0);
+}
+
+/**
+ * @return the i-th tile of the frame (the tiles are numbered line by line).
+ */
+Tile FrameBuffer::GetTile(int i) const
+{
+	Tile tile;
+	tile.x0 = (i % m_NbTilesX) * TILE_SIZE;
+	tile.y0 = (i / m_NbTilesX) * TILE_SIZE;
+	tile.x1 = std::min(tile.x0 + TILE_SIZE, m_Width);
+	tile.y1 = std::min(tile.y0 + TILE_SIZE, m_Height);
+	return tile;
+}
+
+/**
+ * Sets the final color of the pixels [x, x + size[ x [y, y + size[ (clipped
+ * to the frame).
+ */
+void FrameBuffer::FillBlock(int x, int y, int size, const Color& color)
+{
+	int x1 = std::min(x + size, m_Width);
+	int y1 = std::min(y + size, m_Height);
+	for(int j = y; j < y1; j++)
+	{
+		for(int i = x; i < x1; i++)
+			SetColor(i + j * m_Width, color);
+	}
+}
+
+/**
+ * Sets the final color of every pixel to the color of its primary sample.
+ */
+void FrameBuffer::RestoreColors()
+{
+	for(int i = 0; i < m_Width * m_Height; i++)
+		SetColor(i, m_Samples[i]);
+}
+
+/**
+ * Empties the record of the tiles for a scene of nbObjects objects.
+ */
+void FrameBuffer::ResetTileObjects(int nbObjects)
+{
+	m_ObjectWords = nbObjects / 32 + 1;
+	m_TileObjects.assign(GetNbTiles() * m_ObjectWords, 0);
+}
+
+void FrameBuffer::ClearTileObjects(int tile)
+{
+	std::fill_n(GetTileObjects(tile), m_ObjectWords, 0u);
+}
+
+/**
+ * @return true if the rays of a tile touched one of the objects.
+ * @param objects one bit per object, as in the record of the tiles.
+ * @param nbWords number of words of objects (the objects beyond the record of
+ * the tiles are ignored).
+ */
+bool FrameBuffer::TouchesObjects(int tile, const unsigned int* objects, int nbWords) const
+{
+	const unsigned int* touched = &m_TileObjects[tile * m_ObjectWords];
+	const int n = std::min(nbWords, m_ObjectWords);
+	for(int i = 0; i < n; i++)
+	{
+		if(touched[i] & objects[i])
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Converts the final colors to pixels. If the screen is larger than the
+ * frame, the colors are interpolated (bilinear filtering).
+ * @param screen surface of width x height pixels.
+ */
+void FrameBuffer::Convert(Screen screen, int width, int height) const
+{
+	const KernelTable& kernels = GetKernels();
+	if(width == m_Width && height == m_Height)
+	{
+		for(int y = 0; y < m_Height; y++)
+		{
+			int i = y * m_Width;
+			kernels.ConvertColors(&m_Red[i], &m_Green[i], &m_Blue[i], m_Width, screen + i);
+		}
+		return;
+	}
+
+	// position of the columns of the screen in the frame
+	vector<int> x0(width), x1(width);
+	vector<float> fx(width);
+	const float scaleX = (float)m_Width / width;
+	for(int x = 0; x < width; x++)
+	{
+		float u = std::min(std::max((x + 0.5f) * scaleX - 0.5f, 0.0f), m_Width - 1.0f);
+		x0[x] = (int)u;
+		x1[x] = std::min(x0[x] + 1, m_Width - 1);
+		fx[x] = u - x0[x];
+	}
+
+	vector<float> red(width), green(width), blue(width);
+	const float scaleY = (float)m_Height / height;
+	for(int y = 0; y < height; y++)
+	{
+		float v = std::min(std::max((y + 0.5f) * scaleY - 0.5f, 0.0f), m_Height - 1.0f);
+		int y0 = (int)v;
+		int y1 = std::min(y0 + 1, m_Height - 1);
+		float fy = v - y0;
+		const float* planes[3] = {&m_Red[0], &m_Green[0], &m_Blue[0]};
+		float* lines[3] = {&red[0], &green[0], &blue[0]};
+		for(int c = 0; c < 3; c++)
+		{
+			const float* top = planes[c] + y0 * m_Width;
+			const float* bottom = planes[c] + y1 * m_Width;
+			for(int x = 0; x < width; x++)
+			{
+				float t = top[x0[x]] + fx[x] * (top[x1[x]] - top[x0[x]]);
+				float b = bottom[x0[x]] + fx[x] * (bottom[x1[x]] - bottom[x0[x]]);
+				lines[c][x] = t + fy * (b - t);
+			}
+		}
+		kernels.ConvertColors(&red[0], &green[0], &blue[0], width, screen + y * width);
+	}
+}
+
+/**
+ * Converts the final colors of a tile to pixels.
+ * @param screen surface of the size of the frame.
+ */
+void FrameBuffer::ConvertTile(Screen screen, const Tile& tile) const
+{
+	const KernelTable& kernels = GetKernels();
+	for(int y = tile.y0; y < tile.y1; y++)
+	{
+		int i = tile.x0 + y * m_Width;
+		kernels.ConvertColors(&m_Red[i], &m_Green[i], &m_Blue[i], tile.x1 - tile.x0, screen + i);
+	}
+}
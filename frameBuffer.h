@@ -0,0 +1,179 @@
+/**
+* File : frameBuffer.h
+* Description : Buffers filled while rendering a frame. For each pixel, the
+* frame buffer keeps the color of the primary sample (the ray fired through
+* the center of the pixel), its hit (see PrimaryHit) and the final color of
+* the pixel. The frame is rendered tile by tile. Its resolution may be lower than
+* the resolution of the screen, it is then upscaled by Convert.
+* For each tile, the frame buffer also records the objects touched by the rays
+* of its pixels, so that only the tiles showing an edited object are rendered
+* again (see RayTracer::RenderChanges).
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "defs.h"
+#include "rtObjects.h"
+
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------- CONSTS
+
+// width and height of a tile in pixels
+#define TILE_SIZE 32
+
+//----------------------------------------------------------------------- TYPES
+
+// Pixels [x0, x1[ x [y0, y1[ of the frame
+struct Tile
+{
+	int x0, y0, x1, y1;
+};
+
+// Point hit by the primary ray of a pixel (see ReprojectionCache)
+struct PrimaryHit
+{
+	RTObject* object; // 0 if the ray hit nothing
+	Vector3 position;
+	unsigned int lights; // bit i set if the light i (i < 32) is visible from the point
+	int age; // number of frames since the shadow rays have been traced
+
+	PrimaryHit():object(0),lights(0),age(0){}
+};
+
+//----------------------------------------------------------------------- CLASS
+
+// ----------------------------------------------------------------------------
+// FrameBuffer class
+// ----------------------------------------------------------------------------
+
+class FrameBuffer
+{
+public:
+	FrameBuffer(int width, int height);
+
+	void Resize(int width, int height);
+	int GetWidth() const { return m_Width; }
+	int GetHeight() const { return m_Height; }
+	int GetNbTiles() const { return m_NbTilesX * m_NbTilesY; }
+	int GetNbTilesX() const { return m_NbTilesX; }
+	Tile GetTile(int i) const;
+
+	// primary sample of a pixel : also sets the final color of the pixel
+	void SetSample(int x, int y, const Color& color, const PrimaryHit& hit)
+	{
+		int i = x + y * m_Width;
+		m_Samples[i] = color;
+		m_Hits[i] = hit;
+		SetColor(i, color);
+	}
+	const Color& GetSample(int x, int y) const { return m_Samples[x + y * m_Width]; }
+	const PrimaryHit& GetHit(int x, int y) const { return m_Hits[x + y * m_Width]; }
+	RTObject* GetObject(int x, int y) const { return m_Hits[x + y * m_Width].object; }
+
+	void SetColor(int x, int y, const Color& color) { SetColor(x + y * m_Width, color); }
+	void FillBlock(int x, int y, int size, const Color& color);
+	Color GetColor(int x, int y) const
+	{
+		int i = x + y * m_Width;
+		return Color(m_Red[i], m_Green[i], m_Blue[i]);
+	}
+
+	void RestoreColors();
+
+	// final colors, one array per component (line by line)
+	const float* GetRed() const { return &m_Red[0]; }
+	const float* GetGreen() const { return &m_Green[0]; }
+	const float* GetBlue() const { return &m_Blue[0]; }
+
+	// objects touched by the rays of each tile, one bit per object (see
+	// RTObject::GetIndex)
+	void ResetTileObjects(int nbObjects);
+	void ClearTileObjects(int tile);
+	unsigned int* GetTileObjects(int tile) { return &m_TileObjects[tile * m_ObjectWords]; }
+	int GetObjectWords() const { return m_ObjectWords; }
+	bool TouchesObjects(int tile, const unsigned int* objects, int nbWords) const;
+
+	void Convert(Screen screen, int width, int height) const;
+	void ConvertTile(Screen screen, const Tile& tile) const;
+
+private:
+	void SetColor(int i, const Color& color)
+	{
+		m_Red[i] = color.x;
+		m_Green[i] = color.y;
+		m_Blue[i] = color.z;
+	}
+
+	int m_Width, m_Height;
+	int m_NbTilesX, m_NbTilesY;
+	vector<Color> m_Samples;
+	vector<PrimaryHit> m_Hits;
+	// final colors (one array per component for the conversion kernels)
+	vector<float> m_Red, m_Green, m_Blue;
+	int m_ObjectWords; // number of words of the record of a tile
+	vector<unsigned int> m_TileObjects;
+};
+
+// ----------------------------------------------------------------------------
+// Colors of the sub-pixel samples of a tile used by the super-sampling. The
+// samples lie on a lattice twice as fine as the pixels (the sample (X, Y) is
+// at (X / 2, Y / 2) in pixels) : the samples on the corners and the edges of
+// a pixel are shared with its neighbors, so they are only traced once.
+// ----------------------------------------------------------------------------
+
+class SampleCache
+{
+public:
+	SampleCache():m_X0(0),m_Y0(0),m_Width(0),m_Stamp(0){}
+
+	/**
+	 * Empties the cache and covers the samples of the pixels of the tile.
+	 */
+	void Reset(const Tile& tile)
+	{
+		m_X0 = 2 * tile.x0 - 1;
+		m_Y0 = 2 * tile.y0 - 1;
+		m_Width = 2 * (tile.x1 - tile.x0) + 1;
+		size_t size = m_Width * (2 * (tile.y1 - tile.y0) + 1);
+		if(m_Colors.size() < size)
+		{
+			m_Colors.resize(size);
+			m_Stamps.resize(size, 0);
+		}
+		// the entries stored for the previous tiles become invalid
+		m_Stamp++;
+	}
+
+	/**
+	 * @return the sample (X, Y) or 0 if it hasn't been traced yet.
+	 */
+	const Color* Get(int X, int Y) const
+	{
+		int i = (X - m_X0) + (Y - m_Y0) * m_Width;
+		return (m_Stamps[i] == m_Stamp) ? &m_Colors[i] : 0;
+	}
+
+	void Set(int X, int Y, const Color& color)
+	{
+		int i = (X - m_X0) + (Y - m_Y0) * m_Width;
+		m_Colors[i] = color;
+		m_Stamps[i] = m_Stamp;
+	}
+
+private:
+	int m_X0, m_Y0; // first sample of the tile
+	int m_Width; // number of samples per line
+	int m_Stamp; // stamp of the valid entries
+	vector<Color> m_Colors;
+	vector<int> m_Stamps;
+};
+
+#endif // FRAMEBUFFER_H
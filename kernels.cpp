@@ -0,0 +1,77 @@
+/**
+* File : kernels.cpp
+* Description : Selection of the kernels matching the processor.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "kernels.h"
+
+#include <string.h>
+
+//---------------------------------------------------------------------- GLOBALS
+
+// SSE2 is part of every x86-64 processor
+const KernelTable* g_Kernels = &g_KernelsSSE2;
+
+static const KernelTable* s_Tables[ISA_COUNT] =
+{
+	&g_KernelsSSE2,
+	&g_KernelsAVX2,
+	&g_KernelsAVX512
+};
+
+//------------------------------------------------------------------- FUNCTIONS
+
+/**
+ * @return true if the processor (and the operating system) supports the
+ * specified instruction set.
+ */
+bool IsSupported(KernelISA isa)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	__builtin_cpu_init();
+	switch(isa)
+	{
+		case ISA_SSE2:   return __builtin_cpu_supports("sse2");
+		case ISA_AVX2:   return __builtin_cpu_supports("avx2");
+		case ISA_AVX512: return __builtin_cpu_supports("avx512f");
+		default:         return false;
+	}
+#else
+	return isa == ISA_SSE2;
+#endif
+}
+
+KernelISA SelectKernels(const char* name)
+{
+	int isa = ISA_SSE2;
+	for(int i = ISA_COUNT - 1; i > ISA_SSE2; i--)
+	{
+		if(IsSupported((KernelISA)i))
+		{
+			isa = i;
+			break;
+		}
+	}
+
+	if(name)
+	{
+		int forced = 0;
+		while(forced < ISA_COUNT && strcmp(s_Tables[forced]->name, name) != 0)
+			forced++;
+
+		if(forced == ISA_COUNT)
+			fprintf(stderr, "Unknown instruction set %s\n", name);
+		else if(!IsSupported((KernelISA)forced))
+			fprintf(stderr, "Instruction set %s not supported by the processor\n", name);
+		else
+			isa = forced;
+	}
+
+	g_Kernels = s_Tables[isa];
+	return (KernelISA)isa;
+}
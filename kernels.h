@@ -0,0 +1,127 @@
+/**
+* File : kernels.h
+* Description : Hot loops compiled for several instruction sets (SSE2, AVX2,
+* AVX-512) in the same executable. SelectKernels picks the widest version
+* supported by the processor at startup and the rest of the program calls it
+* through the table returned by GetKernels().
+* The kernels only exchange plain data (no Vector3, no Ray) : an inline
+* function of the other headers compiled in a kernel file would contain the
+* instructions of that file, and the linker could keep this copy for the whole
+* program.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "defs.h"
+
+//---------------------------------------------------------------------- CONSTS
+
+// number of floats processed at once by the widest kernels (AVX-512). The
+// arrays read by the kernels must be padded with as many elements.
+#define KERNEL_MAX_WIDTH 16
+
+// weights of the components of a color in its luma (ITU-R BT.601), used by
+// the edge filter (see ComputeLuma)
+#define LUMA_RED 0.299f
+#define LUMA_GREEN 0.587f
+#define LUMA_BLUE 0.114f
+
+//----------------------------------------------------------------------- TYPES
+
+enum KernelISA
+{
+	ISA_SSE2 = 0,
+	ISA_AVX2,
+	ISA_AVX512,
+	ISA_COUNT // number of instruction sets
+};
+
+// Node of a BVH (same layout as BVHNode, with plain floats)
+struct KernelNode
+{
+	float bounds[2][3]; // lower and upper corners
+	int first;
+	int count;
+};
+
+struct KernelRay
+{
+	float origin[3];
+	float dir[3];
+	float invDir[3];
+	int sign[3];
+	float tmin; // the nearer hits are ignored
+};
+
+// Spheres stored as a structure of arrays, ordered by the leaves of a BVH
+struct KernelSpheres
+{
+	const KernelNode* nodes;
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* r2; // square radii
+};
+
+struct KernelTable
+{
+	const char* name;
+
+	/**
+	 * Finds the nearest intersection between a ray and a set of spheres.
+	 * @return infinity if no intersection detected.
+	 */
+	float (*IntersectSpheres)(const KernelSpheres& spheres, const KernelRay& ray);
+
+	/**
+	 * Converts count colors to pixels (the components are saturated at 1).
+	 */
+	void (*ConvertColors)(const float* red, const float* green, const float* blue,
+		int count, Screen dest);
+
+	/**
+	 * Computes the luma of count colors (the components are saturated at 1,
+	 * see LUMA_RED).
+	 */
+	void (*ComputeLuma)(const float* red, const float* green, const float* blue,
+		int count, float* luma);
+
+	/**
+	 * Finds the pixels of a line whose luma contrasts with their 4 neighbors :
+	 * the range of the lumas must be at least minContrast and relContrast
+	 * times the brightest one. line[-1] and line[count] must be readable.
+	 * @param up, line, down lumas of the line and of the lines around it.
+	 * @param edges receives the indices of the pixels found.
+	 * @return the number of pixels found.
+	 */
+	int (*FindEdges)(const float* up, const float* line, const float* down,
+		int count, float minContrast, float relContrast, int* edges);
+};
+
+//------------------------------------------------------------------- FUNCTIONS
+
+extern const KernelTable g_KernelsSSE2;
+extern const KernelTable g_KernelsAVX2;
+extern const KernelTable g_KernelsAVX512;
+extern const KernelTable* g_Kernels;
+
+/**
+ * Selects the kernels used by the program.
+ * @param name name of the instruction set to be used ("sse2", "avx2" or
+ * "avx512"). By default or if the processor doesn't support it, the widest
+ * instruction set supported is used.
+ * @return the selected instruction set.
+ */
+KernelISA SelectKernels(const char* name = 0);
+
+bool IsSupported(KernelISA isa);
+
+inline const KernelTable& GetKernels() { return *g_Kernels; }
+
+#endif // KERNELS_H
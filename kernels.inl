@@ -0,0 +1,219 @@
+/**
+* File : kernels.inl
+* Description : Body of the kernels, compiled once per instruction set. The
+* file including it defines :
+*   KERNEL_FLOAT : packet of floats processed at once (Float4, Float8,...)
+*   KERNEL_INT : mask returned by the comparison of two packets
+*   KERNEL_NAME : name of the instruction set
+*   KERNEL_TABLE : table of kernels to be defined (see kernels.h)
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "kernels.h"
+#include "bvh.h"
+#include "Maths/Vector3xN.h"
+
+namespace {
+
+//----------------------------------------------------------------------- TYPES
+typedef KERNEL_FLOAT Packet;
+typedef KERNEL_INT Mask;
+typedef CVector3xN<Packet> PacketVector3;
+
+//---------------------------------------------------------------------- CONSTS
+const int WIDTH = sizeof(Packet) / sizeof(float);
+
+//------------------------------------------------------------------- FUNCTIONS
+
+/**
+ * Same computation as IntersectSphere (primitives.h) for WIDTH spheres. The
+ * lanes beyond the end of the leaf and the hits nearer than tmin are ignored.
+ */
+inline float IntersectLeaf(const KernelSpheres& s, int first, int count,
+	const PacketVector3& o, const PacketVector3& d, const Packet& tmin)
+{
+	const Packet zero = Packet();
+	const Packet inf = Splat<Packet>(__builtin_inff());
+	Mask lanes = Mask();
+	for(int k = 0; k < WIDTH; k++)
+		lanes[k] = k;
+	Packet best = inf;
+
+	for(int i = first; i < first + count; i += WIDTH)
+	{
+		PacketVector3 center;
+		center.Load(s.x + i, s.y + i, s.z + i);
+		PacketVector3 dst = o - center;
+		Packet b = -Dot(dst, d);
+		Packet det = (b * b) - Dot(dst, dst) + Load<Packet>(s.r2 + i);
+
+		Mask valid = det > zero;
+		valid &= lanes < (first + count - i);
+
+		Packet sq = Sqrt(Max(det, zero));
+		Packet i1 = b - sq;
+		Packet i2 = b + sq;
+		valid &= i2 > tmin;
+		// the nearest root in front of the origin
+		Packet t = Select(i1 < tmin, i2, i1);
+		best = Min(best, Select(valid, t, inf));
+	}
+	return HorizontalMin(best);
+}
+
+/**
+ * Traversal of the BVH of the spheres, in the same order as BVH::Intersect.
+ */
+float IntersectSpheres(const KernelSpheres& s, const KernelRay& ray)
+{
+	float nearest = __builtin_inff();
+	const PacketVector3 o(Splat<Packet>(ray.origin[0]), Splat<Packet>(ray.origin[1]),
+		Splat<Packet>(ray.origin[2]));
+	const PacketVector3 d(Splat<Packet>(ray.dir[0]), Splat<Packet>(ray.dir[1]),
+		Splat<Packet>(ray.dir[2]));
+	const Packet rayMin = Splat<Packet>(ray.tmin);
+
+	int stack[BVH_STACK_SIZE];
+	int nbNodes = 0;
+	stack[nbNodes++] = 0;
+	while(nbNodes > 0)
+	{
+		int index = stack[--nbNodes];
+		const KernelNode& node = s.nodes[index];
+
+		// slab test (see Box::Intersect)
+		float tmin[3], tmax[3];
+		for(int a = 0; a < 3; a++)
+		{
+			tmin[a] = (node.bounds[ray.sign[a]][a] - ray.origin[a]) * ray.invDir[a];
+			tmax[a] = (node.bounds[1 - ray.sign[a]][a] - ray.origin[a]) * ray.invDir[a];
+		}
+		float tnear = MaxF(tmin[0], MaxF(tmin[1], MaxF(tmin[2], 0.0f)));
+		float tfar = MinF(tmax[0], MinF(tmax[1], MinF(tmax[2], nearest)));
+		if(!(tnear <= tfar))
+			continue;
+
+		if(node.count > 0)
+		{
+			float dist = IntersectLeaf(s, node.first, node.count, o, d, rayMin);
+			if(dist < nearest)
+				nearest = dist;
+		}
+		else
+		{
+			stack[nbNodes++] = node.first;
+			stack[nbNodes++] = index + 1;
+		}
+	}
+	return nearest;
+}
+
+/**
+ * The components are multiplied by 256, truncated and clamped to 255 like in
+ * the original loop of RayTracer::Render.
+ */
+void ConvertColors(const float* red, const float* green, const float* blue,
+	int count, Screen dest)
+{
+	const Packet scale = Splat<Packet>(256.0f);
+	const Mask max = Mask() + 255;
+	int i = 0;
+	for(; i + WIDTH <= count; i += WIDTH)
+	{
+		Mask r = __builtin_convertvector(Load<Packet>(red + i) * scale, Mask);
+		Mask g = __builtin_convertvector(Load<Packet>(green + i) * scale, Mask);
+		Mask b = __builtin_convertvector(Load<Packet>(blue + i) * scale, Mask);
+		r = Select(r > max, max, r);
+		g = Select(g > max, max, g);
+		b = Select(b > max, max, b);
+		Mask pixels = (r << 16) + (g << 8) + b;
+		for(int k = 0; k < WIDTH; k++)
+			dest[i + k] = pixels[k];
+	}
+
+	for(; i < count; i++)
+	{
+		int r = (int)(red[i] * 256.0f);
+		int g = (int)(green[i] * 256.0f);
+		int b = (int)(blue[i] * 256.0f);
+		if(r > 255)	r = 255;
+		if(g > 255)	g = 255;
+		if(b > 255)	b = 255;
+		dest[i] = (r << 16) + (g << 8) + b;
+	}
+}
+
+/**
+ * Weights LUMA_RED, LUMA_GREEN and LUMA_BLUE (see kernels.h).
+ */
+void ComputeLuma(const float* red, const float* green, const float* blue,
+	int count, float* luma)
+{
+	const Packet one = Splat<Packet>(1.0f);
+	const Packet wr = Splat<Packet>(LUMA_RED);
+	const Packet wg = Splat<Packet>(LUMA_GREEN);
+	const Packet wb = Splat<Packet>(LUMA_BLUE);
+	int i = 0;
+	for(; i + WIDTH <= count; i += WIDTH)
+	{
+		Packet l = wr * Min(Load<Packet>(red + i), one) + wg * Min(Load<Packet>(green + i), one)
+			+ wb * Min(Load<Packet>(blue + i), one);
+		memcpy(luma + i, &l, sizeof(l));
+	}
+
+	for(; i < count; i++)
+		luma[i] = LUMA_RED * MinF(red[i], 1.0f) + LUMA_GREEN * MinF(green[i], 1.0f)
+			+ LUMA_BLUE * MinF(blue[i], 1.0f);
+}
+
+int FindEdges(const float* up, const float* line, const float* down,
+	int count, float minContrast, float relContrast, int* edges)
+{
+	const Packet minRange = Splat<Packet>(minContrast);
+	const Packet rel = Splat<Packet>(relContrast);
+	int nbEdges = 0;
+	int i = 0;
+	for(; i + WIDTH <= count; i += WIDTH)
+	{
+		Packet m = Load<Packet>(line + i);
+		Packet n = Load<Packet>(up + i);
+		Packet s = Load<Packet>(down + i);
+		Packet w = Load<Packet>(line + i - 1);
+		Packet e = Load<Packet>(line + i + 1);
+		Packet lumaMax = Max(Max(Max(n, s), Max(w, e)), m);
+		Packet lumaMin = Min(Min(Min(n, s), Min(w, e)), m);
+		Mask edge = (lumaMax - lumaMin) >= Max(minRange, lumaMax * rel);
+		// written for every lane, kept only for the edges (edge[k] == -1)
+		for(int k = 0; k < WIDTH; k++)
+		{
+			edges[nbEdges] = i + k;
+			nbEdges -= edge[k];
+		}
+	}
+
+	for(; i < count; i++)
+	{
+		float lumaMax = MaxF(MaxF(MaxF(up[i], down[i]), MaxF(line[i - 1], line[i + 1])), line[i]);
+		float lumaMin = MinF(MinF(MinF(up[i], down[i]), MinF(line[i - 1], line[i + 1])), line[i]);
+		if(lumaMax - lumaMin >= MaxF(minContrast, lumaMax * relContrast))
+			edges[nbEdges++] = i;
+	}
+	return nbEdges;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------- GLOBALS
+
+const KernelTable KERNEL_TABLE =
+{
+	KERNEL_NAME,
+	IntersectSpheres,
+	ConvertColors,
+	ComputeLuma,
+	FindEdges
+};
@@ -0,0 +1,16 @@
+/**
+* File : kernelsAVX2.cpp
+* Description : AVX2 version of the kernels (8 floats per packet).
+* Compiled with the instruction set flags given by the Makefile.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#define KERNEL_FLOAT Float8
+#define KERNEL_INT Int8
+#define KERNEL_NAME "avx2"
+#define KERNEL_TABLE g_KernelsAVX2
+
+#include "kernels.inl"
@@ -0,0 +1,16 @@
+/**
+* File : kernelsAVX512.cpp
+* Description : AVX-512 version of the kernels (16 floats per packet).
+* Compiled with the instruction set flags given by the Makefile.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#define KERNEL_FLOAT Float16
+#define KERNEL_INT Int16
+#define KERNEL_NAME "avx512"
+#define KERNEL_TABLE g_KernelsAVX512
+
+#include "kernels.inl"
@@ -0,0 +1,16 @@
+/**
+* File : kernelsSSE2.cpp
+* Description : SSE2 version of the kernels (4 floats per packet).
+* Compiled with the instruction set flags given by the Makefile.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#define KERNEL_FLOAT Float4
+#define KERNEL_INT Int4
+#define KERNEL_NAME "sse2"
+#define KERNEL_TABLE g_KernelsSSE2
+
+#include "kernels.inl"
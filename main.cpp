@@ -1,225 +1,706 @@
-/**
-* File : Main.cpp
-* Description : Main file
-*
-* Author(s) : ALucchi
-* Date of creation : 27/10/2007
-* Modification(s) :
-*/
-
-//-------------------------------------------------------------------- INCLUDES
-#include "defs.h"
-#include "display.h"
-#include "rayTracer.h"
-
-#include <string.h>
-#include <SDL/SDL.h>
-
-//----------------------------------------------------------------------- TYPES
-
-//------------------------------------------------------------------- VARIABLES
-
-Display		*display = NULL;	// Application's display object
-
-//------------------------------------------------------------------- FUNCTIONS
-
-#ifndef WINDOWS
-#include <sys/times.h>
-long GetTickCount()
-{
-    tms tm;
-    return times(&tm);
-}
-#endif
-
-bool init();
-void deinit();
-bool msgLoop();
-
-int main(int argc, char *argv[])
-{	
-	init();
-
-	RayTracer rayTracer;
-	Color ground(1.0f,0.4f,0.4f);
-	Color red(1.0f,0.1f,0.1f);
-	Color green(0.5f,1.0f,0.2f);
-	Color blue(0.05f,0.05f,0.7f);
-	Color orange(0.9f,0.5f,0.1f);
-	Color white(1.0f,1.0f,1.0f);
-	Color lColor(0.9f,0.8f,0.8f);
-	
-	Plane p(Vector3(0,1,0),6);
-	p.GetMaterial()->SetColor(ground);
-	p.GetMaterial()->SetRefraction(0.0f);
-	p.GetMaterial()->SetDiffuse(1.0f);	
-	Plane p2(Vector3(0,0,1),-20);
-	p2.GetMaterial()->SetColor(white);
-	
-	Sphere s(Vector3(0, -2, 2),0.6f);
-	s.GetMaterial()->SetColor(blue);
-	s.GetMaterial()->SetRefraction(0.5f);
-	Sphere s2(Vector3(-3, -2, 5),1.0f);
-	s2.GetMaterial()->SetColor(blue);
-	s2.GetMaterial()->SetRefraction(0.3f);
-	//s2.GetMaterial()->SetRefrIndex(0.2f);
-	Sphere s3(Vector3(-4, 2, 7),0.5f);
-	s3.GetMaterial()->SetColor(green);
-	s3.GetMaterial()->SetRefraction(0.0f);
-	s3.GetMaterial()->SetDiffuse(0.8f);		
-	
-	cout << "Adding objects\n";
-	
-	for(int i=-3;i<3;i++)
-	for(int j=6;j<12;j++)
-	{
-		Vector3 v(i, -3, j);
-		Sphere* s = new Sphere(v,0.1f);
-		s->GetMaterial()->SetColor(green);
-		s->GetMaterial()->SetRefraction(0.0f);
-		s->GetMaterial()->SetDiffuse(0.8f);		
-		rayTracer.AddObject(s);
-	}	
-	
-	for(int i=-4;i<2;i++)
-	for(int j=8;j<10;j++)
-	{
-		Vector3 v(i, -1, j);
-		Sphere* s = new Sphere(v,0.1f);
-		s->GetMaterial()->SetColor(red);
-		s->GetMaterial()->SetRefraction(0.0f);
-		s->GetMaterial()->SetDiffuse(0.8f);		
-		rayTracer.AddObject(s);
-	}	
-	
-	for(int i=-3;i<3;i++)
-	for(int j=12;j<14;j++)
-	{
-		Vector3 v(i, 1, j);
-		Sphere* s = new Sphere(v,0.1f);
-		s->GetMaterial()->SetColor(orange);
-		s->GetMaterial()->SetRefraction(0.0f);
-		s->GetMaterial()->SetDiffuse(0.8f);		
-		rayTracer.AddObject(s);
-	}
-	
-//	// OK
-//	Triangle t(Vector3(0,0,3),Vector3(1,0,3),Vector3(1,1,3));
-//	t.GetMaterial()->SetColor(green);
-//	t.GetMaterial()->SetRefraction(0.0f);	
-//	
-//	Triangle t2(Vector3(0,0,3),Vector3(0,-2,3),Vector3(1,0,3));
-//	t2.GetMaterial()->SetColor(green);
-//	t2.GetMaterial()->SetRefraction(0.0f);	
-//	
-//	Triangle t3(Vector3(1,-2,3),Vector3(1,0,3),Vector3(0,-2,3));
-//	t3.GetMaterial()->SetColor(green);
-//	t3.GetMaterial()->SetRefraction(0.0f);		
-//	
-//	Triangle t4(Vector3(0,-1,3),Vector3(1,-1,3),Vector3(1,0,3));
-//	t4.GetMaterial()->SetColor(green);
-//	t4.GetMaterial()->SetRefraction(0.0f);	
-//	
-//	Triangle t5(Vector3(0,-2,4),Vector3(1,-2,4),Vector3(0.5,-2,3.98));
-//	t5.GetMaterial()->SetColor(green);
-//	t5.GetMaterial()->SetRefraction(0.0f);	
-	
-	Light l(Vector3(0,3,3),1.0f);
-	l.GetMaterial()->SetColor(lColor);
-	l.GetMaterial()->SetRefraction(0);
-	Light l2(Vector3(4,-3,2),0.7f);
-	l2.GetMaterial()->SetColor(lColor);
-	l2.GetMaterial()->SetRefraction(0);
-	//l2.GetMaterial()->SetColor(lColor);
-	Light l3(Vector3(-3,0,20),0.2f);
-	l3.GetMaterial()->SetColor(lColor);
-	l3.GetMaterial()->SetRefraction(0);
-	Light l4(Vector3(3.5,-1,-2),0.8f);
-	l4.GetMaterial()->SetColor(lColor);
-	l4.GetMaterial()->SetRefraction(0);	
-	
-	rayTracer.AddObject(&p);
-	//rayTracer.AddObject(&t4);
-	//rayTracer.AddObject(&p2);
-	rayTracer.AddObject(&s);
-	//rayTracer.AddObject(&s2);
-	rayTracer.AddObject(&s3);
-	rayTracer.AddObject(&l);
-	//rayTracer.AddObject(&l2);
-	rayTracer.AddObject(&l3);
-	rayTracer.AddObject(&l4);
-
-	rayTracer.ImportASE("mesh/cyl2.ase");
-
-	cout << "Objects added\n";
-
-	long start = GetTickCount();
-
-	display->Clear();
-	rayTracer.Init();
-	rayTracer.Render();
-	display->Flip();
-
-	long end = GetTickCount();
-
-	printf("Time: %ld ms\n", (end-start)*10);
-
-	// Enter the message loop
-	while(msgLoop())
-	{
-	}
-
-	printf("Application over\n");
-
-	return 0;
-}
-
-bool init()
-{
-	display = new Display;
-	
-	// Init display
-	if(!display->Init(SCR_BPP))
-	{
-		display->Deinit();
-		return false;
-	}
-	
-	return true;
-}
-
-void deinit()
-{
-	// Shutdown display
-	if(display)
-	{
-		display->Deinit();
-		delete display;
-	}
-}
-
-bool msgLoop()
-{
-	SDL_Event event;
-	
-	// Parse the SDL events and evetually take some actions
-
-	while(SDL_PollEvent(&event)) {
-		switch(event.type)
-		{
-		case SDL_KEYDOWN:
-			switch(event.key.keysym.sym)
-			{
-				case SDLK_ESCAPE:
-					return false;
-					break;
-			}
-			break;			
-		case SDL_QUIT:
-			return false;
-			break;
-		}
-	}
-
-	return true;
-}
+/**
+* File : Main.cpp
+* Description : Main file
+*
+* Author(s) : ALucchi
+* Date of creation : 27/10/2007
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "defs.h"
+#include "display.h"
+#include "rayTracer.h"
+#include "sphereCloud.h"
+#include "mesh.h"
+#include "kernels.h"
+
+#include <string.h>
+#include <SDL/SDL.h>
+
+//---------------------------------------------------------------------- CONSTS
+
+// distance covered by the camera each time an arrow key is pressed
+#define CAMERA_STEP 0.05f
+// distance covered by the moving sphere each time page up/down is pressed
+#define OBJECT_STEP 0.25f
+// number of random rays traced by --bvh-bench
+#define BENCH_RAYS 100000
+// cost of the box test of the primitives of --bvh-bench relative to the
+// traversal of a node (see BVH::SetIntersectionCost)
+#define BENCH_INTERSECTION_COST 0.25f
+
+//----------------------------------------------------------------------- TYPES
+
+//------------------------------------------------------------------- VARIABLES
+
+Display		*display = NULL;	// Application's display object
+
+// names of the split methods of the BVH (see BVHSplit)
+static const char* s_SplitNames[] = {"median", "sah", "morton", "morton+sah", "spatial"};
+
+//------------------------------------------------------------------- FUNCTIONS
+
+#ifndef WINDOWS
+#include <sys/times.h>
+long GetTickCount()
+{
+    tms tm;
+    return times(&tm);
+}
+#endif
+
+bool init();
+void deinit();
+bool msgLoop(Vector3& move, float& lift, bool& edit);
+void benchBVH(int nbPrims);
+void benchMesh(const char* strFileName);
+int GetSplitMethod(const char* name);
+
+int main(int argc, char *argv[])
+{	
+	// instruction set of the kernels : --isa sse2|avx2|avx512 (widest by default)
+	// options of the render : --no-aa, --adaptive-aa [depth],
+	// --post-aa [objects], --no-grid, --vertex-normals, --progressive [block],
+	// --budget [ms] (frames rendered continuously within the time budget),
+	// --min-weight [w] (secondary rays weaker than w are not traced),
+	// --russian-roulette (they are traced randomly instead, and weighted up),
+	// --stereo [distance] (left and right views shown one after the other),
+	// --reproject (the arrow keys move the camera, the frames reuse the hits
+	// of the previous one), --animate (a wave runs through the green spheres,
+	// their BVH is refitted each frame, as the BVH of the ducks),
+	// --instances [n] (n ducks sharing the same triangles)
+	// --scene-bvh [median|sah|morton|morton+sah|spatial] traverses a BVH of
+	// the scene instead of the grid (morton by default)
+	// --quantized-bvh stores the bounds of the wide BVH of the scene on 8 bits
+	// --bvh-bench [n] builds BVHs over n random spheres with each split
+	// method, prints their build time, their cost and the time taken by the
+	// binary, wide and quantized BVHs to trace random rays, and quits
+	// --mesh-bench file.ase compares the BVHs of the mesh built with the SAH
+	// and with the spatial splits, and quits
+	// the space bar changes the color of a sphere, only the tiles showing it
+	// are rendered again. Page up/down move this sphere, only the cells of
+	// the grid around it are updated.
+	const char* isa = 0;
+	int renderFlags = DEFAULT_RENDER_FLAGS;
+	int aaDepth = ADAPTIVE_AA_DEPTH;
+	bool aaObjects = false;
+	int progressiveBlock = PROGRESSIVE_BLOCK;
+	float budget = 0;
+	float minWeight = MIN_RAY_WEIGHT;
+	bool russianRoulette = false;
+	float stereo = 0;
+	bool animate = false;
+	int nbInstances = 0;
+	int benchPrims = 0;
+	const char* benchFile = 0;
+	int sceneSplit = -1;
+	bool quantized = false;
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--isa") == 0 && i + 1 < argc)
+			isa = argv[++i];
+		else if(strcmp(argv[i], "--no-aa") == 0)
+			renderFlags &= ~RENDER_AA_MASK;
+		else if(strcmp(argv[i], "--adaptive-aa") == 0)
+		{
+			renderFlags = (renderFlags & ~RENDER_AA_MASK) | RENDER_ADAPTIVE_AA;
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				aaDepth = atoi(argv[++i]);
+		}
+		else if(strcmp(argv[i], "--post-aa") == 0)
+		{
+			renderFlags = (renderFlags & ~RENDER_AA_MASK) | RENDER_POST_AA;
+			if(i + 1 < argc && strcmp(argv[i + 1], "objects") == 0)
+			{
+				aaObjects = true;
+				i++;
+			}
+		}
+		else if(strcmp(argv[i], "--no-grid") == 0)
+			renderFlags &= ~RENDER_SPATIAL_DIVISION;
+		else if(strcmp(argv[i], "--vertex-normals") == 0)
+			renderFlags |= RENDER_VERTEX_NORMALS;
+		else if(strcmp(argv[i], "--progressive") == 0)
+		{
+			renderFlags |= RENDER_PROGRESSIVE;
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				progressiveBlock = atoi(argv[++i]);
+		}
+		else if(strcmp(argv[i], "--reproject") == 0)
+			renderFlags |= RENDER_REPROJECTION;
+		else if(strcmp(argv[i], "--stereo") == 0)
+		{
+			stereo = 0.2f;
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				stereo = (float)atof(argv[++i]);
+		}
+		else if(strcmp(argv[i], "--animate") == 0)
+			animate = true;
+		else if(strcmp(argv[i], "--instances") == 0)
+		{
+			nbInstances = 100;
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				nbInstances = atoi(argv[++i]);
+		}
+		else if(strcmp(argv[i], "--scene-bvh") == 0)
+		{
+			sceneSplit = BVH_SPLIT_MORTON;
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				sceneSplit = GetSplitMethod(argv[++i]);
+		}
+		else if(strcmp(argv[i], "--quantized-bvh") == 0)
+			quantized = true;
+		else if(strcmp(argv[i], "--bvh-bench") == 0)
+		{
+			benchPrims = 100000;
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				benchPrims = atoi(argv[++i]);
+		}
+		else if(strcmp(argv[i], "--mesh-bench") == 0 && i + 1 < argc)
+			benchFile = argv[++i];
+		else if(strcmp(argv[i], "--min-weight") == 0)
+		{
+			minWeight = 0.05f;
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				minWeight = (float)atof(argv[++i]);
+		}
+		else if(strcmp(argv[i], "--russian-roulette") == 0)
+			russianRoulette = true;
+		else if(strcmp(argv[i], "--budget") == 0)
+		{
+			budget = FRAME_BUDGET_TARGET;
+			if(i + 1 < argc && argv[i + 1][0] != '-')
+				budget = (float)atof(argv[++i]);
+		}
+	}
+	SelectKernels(isa);
+	printf("Kernels: %s\n", GetKernels().name);
+
+	init();
+
+	if(benchFile)
+	{
+		benchMesh(benchFile);
+		deinit();
+		return 0;
+	}
+	if(benchPrims > 0)
+	{
+		benchBVH(benchPrims);
+		deinit();
+		return 0;
+	}
+
+	RayTracer rayTracer;
+	rayTracer.SetRenderFlags(renderFlags);
+	rayTracer.SetAdaptiveDepth(aaDepth);
+	rayTracer.GetEdgeFilter().SetObjectGuided(aaObjects);
+	rayTracer.SetProgressiveBlock(progressiveBlock);
+	rayTracer.GetFrameBudget().SetTarget(budget);
+	rayTracer.SetMinWeight(minWeight);
+	rayTracer.SetRussianRoulette(russianRoulette);
+	Color ground(1.0f,0.4f,0.4f);
+	Color red(1.0f,0.1f,0.1f);
+	Color green(0.5f,1.0f,0.2f);
+	Color blue(0.05f,0.05f,0.7f);
+	Color orange(0.9f,0.5f,0.1f);
+	Color white(1.0f,1.0f,1.0f);
+	Color lColor(0.9f,0.8f,0.8f);
+	
+	Plane p(Vector3(0,1,0),6);
+	p.GetMaterial()->SetColor(ground);
+	p.GetMaterial()->SetRefraction(0.0f);
+	p.GetMaterial()->SetDiffuse(1.0f);	
+	Plane p2(Vector3(0,0,1),-20);
+	p2.GetMaterial()->SetColor(white);
+	
+	Sphere s(Vector3(0, -2, 2),0.6f);
+	s.GetMaterial()->SetColor(blue);
+	s.GetMaterial()->SetRefraction(0.5f);
+	Sphere s2(Vector3(-3, -2, 5),1.0f);
+	s2.GetMaterial()->SetColor(blue);
+	s2.GetMaterial()->SetRefraction(0.3f);
+	//s2.GetMaterial()->SetRefrIndex(0.2f);
+	Sphere s3(Vector3(-4, 2, 7),0.5f);
+	s3.GetMaterial()->SetColor(green);
+	s3.GetMaterial()->SetRefraction(0.0f);
+	s3.GetMaterial()->SetDiffuse(0.8f);		
+	
+	cout << "Adding objects\n";
+	
+	// Small spheres are grouped in clouds (one per color). They used to be
+	// spheres of square radius 0.1 (see Sphere).
+	SphereCloud greenCloud, redCloud, orangeCloud;
+	const float smallRadius = sqrtf(0.1f);
+	vector<Vector3> greenCenters;
+	
+	for(int i=-3;i<3;i++)
+	for(int j=6;j<12;j++)
+	{
+		greenCloud.AddSphere(Vector3(i, -3, j), smallRadius);
+		greenCenters.push_back(Vector3(i, -3, j));
+	}
+	greenCloud.GetMaterial()->SetColor(green);
+	greenCloud.GetMaterial()->SetRefraction(0.0f);
+	greenCloud.GetMaterial()->SetDiffuse(0.8f);
+	greenCloud.Build();
+	rayTracer.AddObject(&greenCloud);
+	
+	for(int i=-4;i<2;i++)
+	for(int j=8;j<10;j++)
+		redCloud.AddSphere(Vector3(i, -1, j), smallRadius);
+	redCloud.GetMaterial()->SetColor(red);
+	redCloud.GetMaterial()->SetRefraction(0.0f);
+	redCloud.GetMaterial()->SetDiffuse(0.8f);
+	redCloud.Build();
+	rayTracer.AddObject(&redCloud);
+	
+	for(int i=-3;i<3;i++)
+	for(int j=12;j<14;j++)
+		orangeCloud.AddSphere(Vector3(i, 1, j), smallRadius);
+	orangeCloud.GetMaterial()->SetColor(orange);
+	orangeCloud.GetMaterial()->SetRefraction(0.0f);
+	orangeCloud.GetMaterial()->SetDiffuse(0.8f);
+	orangeCloud.Build();
+	rayTracer.AddObject(&orangeCloud);
+	
+//	// OK
+//	Triangle t(Vector3(0,0,3),Vector3(1,0,3),Vector3(1,1,3));
+//	t.GetMaterial()->SetColor(green);
+//	t.GetMaterial()->SetRefraction(0.0f);	
+//	
+//	Triangle t2(Vector3(0,0,3),Vector3(0,-2,3),Vector3(1,0,3));
+//	t2.GetMaterial()->SetColor(green);
+//	t2.GetMaterial()->SetRefraction(0.0f);	
+//	
+//	Triangle t3(Vector3(1,-2,3),Vector3(1,0,3),Vector3(0,-2,3));
+//	t3.GetMaterial()->SetColor(green);
+//	t3.GetMaterial()->SetRefraction(0.0f);		
+//	
+//	Triangle t4(Vector3(0,-1,3),Vector3(1,-1,3),Vector3(1,0,3));
+//	t4.GetMaterial()->SetColor(green);
+//	t4.GetMaterial()->SetRefraction(0.0f);	
+//	
+//	Triangle t5(Vector3(0,-2,4),Vector3(1,-2,4),Vector3(0.5,-2,3.98));
+//	t5.GetMaterial()->SetColor(green);
+//	t5.GetMaterial()->SetRefraction(0.0f);	
+	
+	Light l(Vector3(0,3,3),1.0f);
+	l.GetMaterial()->SetColor(lColor);
+	l.GetMaterial()->SetRefraction(0);
+	Light l2(Vector3(4,-3,2),0.7f);
+	l2.GetMaterial()->SetColor(lColor);
+	l2.GetMaterial()->SetRefraction(0);
+	//l2.GetMaterial()->SetColor(lColor);
+	Light l3(Vector3(-3,0,20),0.2f);
+	l3.GetMaterial()->SetColor(lColor);
+	l3.GetMaterial()->SetRefraction(0);
+	Light l4(Vector3(3.5,-1,-2),0.8f);
+	l4.GetMaterial()->SetColor(lColor);
+	l4.GetMaterial()->SetRefraction(0);	
+	
+	rayTracer.AddObject(&p);
+	//rayTracer.AddObject(&t4);
+	//rayTracer.AddObject(&p2);
+	rayTracer.AddObject(&s);
+	//rayTracer.AddObject(&s2);
+	rayTracer.AddObject(&s3);
+	rayTracer.AddObject(&l);
+	//rayTracer.AddObject(&l2);
+	rayTracer.AddObject(&l3);
+	rayTracer.AddObject(&l4);
+
+	rayTracer.ImportASE("mesh/cyl2.ase");
+
+	// ducks on the ground behind the spheres, in a square turned to the camera
+	vector<MeshInstance*> instances;
+	Mesh* duck = 0;
+	vector<Vector3> duckVertices, duckNormals;
+	if(nbInstances > 0)
+	{
+		duck = rayTracer.LoadMesh("mesh/duck.ase");
+		duck->GetVertices(duckVertices, duckNormals);
+		int side = (int)ceilf(sqrtf((float)nbInstances));
+		for(int k = 0; k < nbInstances; k++)
+		{
+			Mat4x4 transform;
+			// turned around their origin, then placed (R.T)
+			transform.translate(((k % side) - side * 0.5f) * 2.5f, -6, 16 + (k / side) * 2.5f);
+			transform.rotate(0, (float)(k * 37), 0);
+			MeshInstance* instance = new MeshInstance(duck, transform);
+			rayTracer.AddObject(instance);
+			instances.push_back(instance);
+		}
+		printf("Instances: %d of %d triangles\n", nbInstances, duck->GetNbTriangles());
+	}
+
+	cout << "Objects added\n";
+
+	long start = GetTickCount();
+
+	display->Clear();
+	rayTracer.Init();
+	if(sceneSplit >= 0)
+	{
+		Uint32 buildStart = SDL_GetTicks();
+		rayTracer.SetAcceleration(ACCEL_BVH, (BVHSplit)sceneSplit, quantized);
+		const BVH& bvh = rayTracer.GetSceneBVH();
+		printf("Scene BVH (%s): %d primitives, %u ms, cost %.2f, %d wide nodes (%d bytes)\n",
+			s_SplitNames[sceneSplit], (int)bvh.GetIndices().size(), SDL_GetTicks() - buildStart,
+			bvh.GetCost(), rayTracer.GetSceneWideBVH().GetNbNodes(),
+			rayTracer.GetSceneWideBVH().GetMemory());
+	}
+	if(stereo > 0)
+	{
+		// both eyes in one job, on each side of the camera of the ray tracer
+		const Camera& camera = rayTracer.GetCamera();
+		const Mat4x4& axes = camera.GetOrientation();
+		Vector3 right(axes._11, axes._12, axes._13);
+		Camera eyes[2] = {camera, camera};
+		eyes[0].SetPosition(camera.GetPosition() - right * (stereo * 0.5f));
+		eyes[1].SetPosition(camera.GetPosition() + right * (stereo * 0.5f));
+		FrameBuffer frames[2] = {FrameBuffer(SCR_WIDTH, SCR_HEIGHT), FrameBuffer(SCR_WIDTH, SCR_HEIGHT)};
+		View views[2] = {View(&eyes[0], &frames[0]), View(&eyes[1], &frames[1])};
+		rayTracer.RenderViews(views, 2);
+		frames[0].Convert(display->GetScreen(), SCR_WIDTH, SCR_HEIGHT);
+		display->Flip();
+		frames[1].Convert(display->GetScreen(), SCR_WIDTH, SCR_HEIGHT);
+	}
+	else
+		rayTracer.Render();
+	display->Flip();
+
+	long end = GetTickCount();
+
+	printf("Time: %ld ms\n", (end-start)*10);
+
+	const RenderStats& stats = rayTracer.GetStats();
+	int secondary = stats.secondaryRays + stats.culledRays;
+	printf("Rays: %d primary, %d secondary, %d shadow\n",
+		stats.primaryRays, stats.secondaryRays, stats.shadowRays);
+	printf("Culled: %d secondary rays (%.1f%%)\n", stats.culledRays,
+		secondary ? 100.0f * stats.culledRays / secondary : 0.0f);
+
+	// Enter the message loop
+	Vector3 move;
+	float lift;
+	bool edit;
+	int frame = 0;
+	while(msgLoop(move, lift, edit))
+	{
+		if(animate)
+		{
+			vector<Vector3> centers(greenCenters);
+			frame++;
+			for(size_t k = 0; k < centers.size(); k++)
+				centers[k].y += 0.5f * sinf(frame * 0.5f + centers[k].z);
+			Uint32 refitStart = SDL_GetTicks();
+			greenCloud.SetCenters(centers);
+			bool rebuilt = greenCloud.Refit();
+			rayTracer.UpdateObject(&greenCloud);
+			printf("Refit: %u ms, degradation %.2f%s\n", SDL_GetTicks() - refitStart,
+				greenCloud.GetBVH().GetDegradation(), rebuilt ? " (built again)" : "");
+
+			if(duck)
+			{
+				// the ducks are squashed and stretched along their height
+				vector<Vector3> vertices(duckVertices);
+				float scale = 1.0f + 0.2f * sinf(frame * 0.5f);
+				for(size_t k = 0; k < vertices.size(); k++)
+					vertices[k].y *= scale;
+				refitStart = SDL_GetTicks();
+				duck->SetVertices(vertices, duckNormals);
+				rebuilt = duck->Refit();
+				for(size_t k = 0; k < instances.size(); k++)
+				{
+					instances[k]->UpdateBounds();
+					rayTracer.UpdateObject(instances[k]);
+				}
+				printf("Mesh refit: %u ms, degradation %.2f%s\n", SDL_GetTicks() - refitStart,
+					duck->GetBVH().GetDegradation(), rebuilt ? " (built again)" : "");
+			}
+		}
+
+		if(edit)
+		{
+			// the sphere alternates between green and blue
+			Color color = (s3.GetMaterial()->GetColor().y > 0.5f) ? blue : green;
+			s3.GetMaterial()->SetColor(color);
+			rayTracer.Invalidate(&s3);
+			Uint32 editStart = SDL_GetTicks();
+			int nbTiles = rayTracer.RenderChanges();
+			display->Flip();
+			printf("Edit: %u ms, %d tiles rendered\n", SDL_GetTicks() - editStart, nbTiles);
+		}
+
+		bool moved = move.x != 0 || move.z != 0;
+		if(moved)
+		{
+			// along the right and forward axes of the camera
+			Camera& camera = rayTracer.GetCamera();
+			const Mat4x4& axes = camera.GetOrientation();
+			Vector3 right(axes._11, axes._12, axes._13);
+			Vector3 forward(axes._31, axes._32, axes._33);
+			camera.SetPosition(camera.GetPosition() + right * move.x + forward * move.z);
+		}
+		if(lift != 0)
+		{
+			Uint32 updateStart = SDL_GetTicks();
+			rayTracer.MoveObject(&s3, Vector3(0, lift, 0));
+			printf("Update: %u ms\n", SDL_GetTicks() - updateStart);
+		}
+		if(budget > 0 || moved || lift != 0 || animate)
+		{
+			Uint32 frameStart = SDL_GetTicks();
+			rayTracer.Render();
+			display->Flip();
+			secondary = stats.secondaryRays + stats.culledRays;
+			printf("Frame: %u ms, quality %d (%dx%d), %d shadow rays, %d secondary rays culled "
+				"(%.1f%%), %d pixels reprojected\n", SDL_GetTicks() - frameStart, stats.quality,
+				stats.width, stats.height, stats.shadowRays, stats.culledRays,
+				secondary ? 100.0f * stats.culledRays / secondary : 0.0f, stats.reprojected);
+		}
+	}
+
+	for(size_t k = 0; k < instances.size(); k++)
+		delete instances[k];
+
+	printf("Application over\n");
+
+	return 0;
+}
+
+bool init()
+{
+	// tables of Mat4x4::rotate
+	mathInit();
+	display = new Display;
+	
+	// Init display
+	if(!display->Init(SCR_BPP))
+	{
+		display->Deinit();
+		return false;
+	}
+	
+	return true;
+}
+
+void deinit()
+{
+	// Shutdown display
+	if(display)
+	{
+		display->Deinit();
+		delete display;
+	}
+	mathDeinit();
+}
+
+/**
+ * Processes the pending events.
+ * @param move receives the move of the camera asked with the arrow keys (x
+ * along its right axis, z along its forward axis).
+ * @param lift receives the vertical move of the sphere asked with page up/down.
+ * @param edit set to true if the space bar has been pressed.
+ * @return false when the application must quit.
+ */
+bool msgLoop(Vector3& move, float& lift, bool& edit)
+{
+	SDL_Event event;
+	move = Vector3(0, 0, 0);
+	lift = 0;
+	edit = false;
+	
+	// Parse the SDL events and evetually take some actions
+
+	while(SDL_PollEvent(&event)) {
+		switch(event.type)
+		{
+		case SDL_KEYDOWN:
+			switch(event.key.keysym.sym)
+			{
+				case SDLK_ESCAPE:
+					return false;
+					break;
+				case SDLK_LEFT:
+					move.x -= CAMERA_STEP;
+					break;
+				case SDLK_RIGHT:
+					move.x += CAMERA_STEP;
+					break;
+				case SDLK_UP:
+					move.z += CAMERA_STEP;
+					break;
+				case SDLK_DOWN:
+					move.z -= CAMERA_STEP;
+					break;
+				case SDLK_PAGEUP:
+					lift += OBJECT_STEP;
+					break;
+				case SDLK_PAGEDOWN:
+					lift -= OBJECT_STEP;
+					break;
+				case SDLK_SPACE:
+					edit = true;
+					break;
+			}
+			break;			
+		case SDL_QUIT:
+			return false;
+			break;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Intersects the boxes of a leaf of the BVHs of benchBVH
+ */
+struct BenchLeafTest
+{
+	const vector<Box>& m_Bounds;
+	const vector<int>& m_Indices;
+
+	BenchLeafTest(const vector<Box>& bounds, const vector<int>& indices):
+		m_Bounds(bounds),m_Indices(indices){}
+	float operator()(int first, int count, const Ray& ray) const
+	{
+		float nearest = std::numeric_limits<float>::infinity();
+		for(int i = first; i < first + count; i++)
+		{
+			float tnear, tfar;
+			if(m_Bounds[m_Indices[i]].Intersect(ray, 0, nearest, tnear, tfar))
+				nearest = tnear;
+		}
+		return nearest;
+	}
+};
+
+/**
+ * Builds a BVH over nbPrims random spheres with each split method and prints
+ * the build time and the SAH cost of the trees (lower is better).
+ */
+void benchBVH(int nbPrims)
+{
+	srand(0);
+	vector<Box> bounds(nbPrims);
+	for(int i = 0; i < nbPrims; i++)
+	{
+		Vector3 center(rand() * 200.0f / RAND_MAX - 100.0f, rand() * 200.0f / RAND_MAX - 100.0f,
+			rand() * 200.0f / RAND_MAX - 100.0f);
+		float r = 0.1f + rand() * 1.9f / RAND_MAX;
+		bounds[i] = Box(center - Vector3(r, r, r), center + Vector3(r, r, r));
+	}
+
+	for(int split = BVH_SPLIT_MEDIAN; split <= BVH_SPLIT_SPATIAL; split++)
+	{
+		BVH bvh;
+		bvh.SetSplitMethod((BVHSplit)split);
+		bvh.SetIntersectionCost(BENCH_INTERSECTION_COST);
+		Uint32 start = SDL_GetTicks();
+		bvh.Build(bounds, CLOUD_LEAF_SIZE);
+		printf("BVH %-10s: %d primitives, %u ms, %d nodes, cost %.2f\n", s_SplitNames[split], nbPrims,
+			SDL_GetTicks() - start, (int)bvh.GetNodes().size(), bvh.GetCost());
+
+		WideBVH wide, quantized;
+		wide.Build(bvh);
+		quantized.Build(bvh, true);
+		BenchLeafTest test(bounds, bvh.GetIndices());
+		Uint32 times[3] = {0, 0, 0};
+		int misses = 0;
+		srand(1);
+		for(int i = 0; i < BENCH_RAYS; i++)
+		{
+			Vector3 origin(rand() * 200.0f / RAND_MAX - 100.0f, rand() * 200.0f / RAND_MAX - 100.0f,
+				rand() * 200.0f / RAND_MAX - 100.0f);
+			Vector3 dir(rand() * 2.0f / RAND_MAX - 1.0f, rand() * 2.0f / RAND_MAX - 1.0f,
+				rand() * 2.0f / RAND_MAX - 1.0f);
+			dir.Normalize();
+			Ray ray(origin, dir, i);
+			Uint32 t0 = SDL_GetTicks();
+			float d0 = bvh.Intersect(ray, test);
+			Uint32 t1 = SDL_GetTicks();
+			float d1 = wide.Intersect(ray, test);
+			Uint32 t2 = SDL_GetTicks();
+			float d2 = quantized.Intersect(ray, test);
+			times[0] += t1 - t0;
+			times[1] += t2 - t1;
+			times[2] += SDL_GetTicks() - t2;
+			misses += (d1 != d0) + (d2 != d0);
+		}
+		printf("  %d rays : binary %u ms (%d KB), wide %u ms (%d KB), quantized %u ms (%d KB), %d misses\n",
+			BENCH_RAYS, times[0], (int)(bvh.GetNodes().size() * sizeof(BVHNode) / 1024),
+			times[1], wide.GetMemory() / 1024, times[2], quantized.GetMemory() / 1024, misses);
+	}
+}
+
+/**
+ * Loads the mesh of the file with the SAH and with the spatial splits, and
+ * compares the BVHs and the time taken by random rays aimed at the mesh.
+ */
+void benchMesh(const char* strFileName)
+{
+	const BVHSplit splits[2] = {BVH_SPLIT_SAH, BVH_SPLIT_SPATIAL};
+	for(int s = 0; s < 2; s++)
+	{
+		Scene scene;
+		Uint32 start = SDL_GetTicks();
+		Mesh* mesh = scene.LoadMesh(strFileName, splits[s]);
+		const BVH& bvh = mesh->GetBVH();
+		printf("Mesh %s (%s): %d triangles, %d references, %u ms, %d nodes, cost %.2f\n",
+			strFileName, s_SplitNames[splits[s]], mesh->GetNbTriangles(),
+			(int)bvh.GetIndices().size(), SDL_GetTicks() - start, (int)bvh.GetNodes().size(),
+			bvh.GetCost());
+		if(mesh->GetNbTriangles() == 0)
+			return;
+
+		// from a sphere around the mesh to a point of its bounds
+		Box bounds = mesh->GetBounds();
+		Vector3 center = bounds.GetCenter(), size = bounds.GetSize();
+		float radius = size.Length();
+		int hits = 0;
+		double total = 0;
+		srand(1);
+		start = SDL_GetTicks();
+		for(int i = 0; i < BENCH_RAYS; i++)
+		{
+			Vector3 dir(rand() * 2.0f / RAND_MAX - 1.0f, rand() * 2.0f / RAND_MAX - 1.0f,
+				rand() * 2.0f / RAND_MAX - 1.0f);
+			dir.Normalize();
+			Vector3 target(rand() * 1.0f / RAND_MAX - 0.5f, rand() * 1.0f / RAND_MAX - 0.5f,
+				rand() * 1.0f / RAND_MAX - 0.5f);
+			target = center + Vector3(target.x * size.x, target.y * size.y, target.z * size.z);
+			Vector3 origin = center + dir * radius;
+			Vector3 toTarget = target - origin;
+			toTarget.Normalize();
+			Ray ray(origin, toTarget, i);
+			int triangle;
+			float dist = mesh->Intersect(ray, 0, triangle);
+			if(dist < std::numeric_limits<float>::infinity())
+			{
+				hits++;
+				total += dist;
+			}
+		}
+		printf("  %d rays : %u ms, %d hits (mean distance %.4f)\n", BENCH_RAYS,
+			SDL_GetTicks() - start, hits, hits ? total / hits : 0.0);
+	}
+}
+
+/**
+ * @return the split method of the BVH with the specified name (see
+ * s_SplitNames), BVH_SPLIT_MORTON if unknown.
+ */
+int GetSplitMethod(const char* name)
+{
+	for(int split = BVH_SPLIT_MEDIAN; split <= BVH_SPLIT_SPATIAL; split++)
+	{
+		if(strcmp(s_SplitNames[split], name) == 0)
+			return split;
+	}
+	fprintf(stderr, "Unknown BVH split method %s\n", name);
+	return BVH_SPLIT_MORTON;
+}
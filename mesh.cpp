@@ -0,0 +1,393 @@
+/**
+* File : mesh.cpp
+* Description : Triangle meshes shared by several instances.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "mesh.h"
+#include "defs.h"
+
+//--------------------------------------------------------------------- HELPERS
+
+/**
+ * Intersects the triangles of a leaf of the BVH of a mesh (see BVH::Intersect)
+ * and keeps the nearest one.
+ */
+struct TriangleLeafTest
+{
+	const vector<TriangleData>& m_Triangles;
+	float m_tmin; // the nearer hits are ignored
+	float m_nearest; // distance of m_nearestTriangle (the farther hits are ignored)
+	int m_nearestTriangle;
+
+	TriangleLeafTest(const vector<TriangleData>& triangles, float tmin, float tmax):
+		m_Triangles(triangles),m_tmin(tmin),m_nearest(tmax),m_nearestTriangle(-1){}
+	float operator()(int first, int count, const Ray& ray)
+	{
+		for(int i = first; i < first + count; i++)
+		{
+			float dist = IntersectTriangle(m_Triangles[i], ray);
+			if(dist < m_nearest && dist > m_tmin)
+			{
+				m_nearest = dist;
+				m_nearestTriangle = i;
+			}
+		}
+		return m_nearest;
+	}
+};
+
+/**
+ * @return the barycentric coordinates (v, w) of the projection of pos on the
+ * plane of the triangle ABC, false if the triangle is degenerate.
+ */
+static bool GetBarycentric(const Vector3& A, const Vector3& B, const Vector3& C,
+	const Vector3& pos, float& v, float& w)
+{
+	Vector3 AB = B - A;
+	Vector3 AC = C - A;
+	Vector3 AP = pos - A;
+	float d00 = Dot(AB, AB);
+	float d01 = Dot(AB, AC);
+	float d11 = Dot(AC, AC);
+	float d20 = Dot(AP, AB);
+	float d21 = Dot(AP, AC);
+	float denom = d00 * d11 - d01 * d01;
+	if(denom == 0)
+		return false;
+
+	v = (d11 * d20 - d01 * d21) / denom;
+	w = (d00 * d21 - d01 * d20) / denom;
+	return true;
+}
+
+//--------------------------------------------------------------------- METHODS
+
+/**
+ * The BVH of the meshes is built with the SAH. The spatial splits copy the
+ * triangles they split in each leaf, they are only worth it for the meshes
+ * made of long and thin triangles (see SetSplitMethod).
+ */
+Mesh::Mesh():m_NbTriangles(0),m_Clipper(m_Vertices),m_MaxDegradation(BVH_MAX_DEGRADATION)
+{
+	m_Bvh.SetSplitMethod(BVH_SPLIT_SAH);
+	m_Bvh.SetClipper(&m_Clipper);
+}
+
+/**
+ * Adds a triangle to the mesh. Build must be called once all the triangles
+ * have been added.
+ */
+void Mesh::AddTriangle(const Vector3 vertices[3], const Vector3 normals[3])
+{
+	TriangleData t;
+	SetTriangleData(t, vertices[0], vertices[1], vertices[2]);
+	t.rayID = -1;
+	t.object = 0;
+	m_Triangles.push_back(t);
+	m_Order.push_back(m_NbTriangles);
+	m_NbTriangles++;
+	for(int k = 0; k < 3; k++)
+	{
+		m_Vertices.push_back(vertices[k]);
+		m_Normals.push_back(normals[k]);
+	}
+}
+
+/**
+ * Build the BVH of the mesh, sort the triangles in the order of its leaves and
+ * collapse it into the 4-wide BVH traversed by the rays. Must be called after
+ * all the triangles have been added, and can be called again once the
+ * vertices moved (see Refit).
+ */
+void Mesh::Build()
+{
+	// back to one copy of each triangle, in the order of AddTriangle
+	const int nbTriangles = m_NbTriangles;
+	{
+		vector<TriangleData> triangles(nbTriangles);
+		vector<Vector3> vertices(3 * nbTriangles), normals(3 * nbTriangles);
+		for(size_t i = 0; i < m_Order.size(); i++)
+		{
+			int j = m_Order[i];
+			triangles[j] = m_Triangles[i];
+			for(int k = 0; k < 3; k++)
+			{
+				vertices[3 * j + k] = m_Vertices[3 * i + k];
+				normals[3 * j + k] = m_Normals[3 * i + k];
+			}
+		}
+		m_Triangles.swap(triangles);
+		m_Vertices.swap(vertices);
+		m_Normals.swap(normals);
+	}
+
+	vector<Box> bounds(nbTriangles);
+	for(int i = 0; i < nbTriangles; i++)
+	{
+		for(int k = 0; k < 3; k++)
+			bounds[i].Extend(m_Vertices[3 * i + k]);
+	}
+	m_Bvh.Build(bounds, MESH_LEAF_SIZE);
+
+	// one copy of a triangle per reference of the leaves
+	const vector<int>& indices = m_Bvh.GetIndices();
+	const int nbRefs = (int)indices.size();
+	vector<TriangleData> triangles(nbRefs);
+	vector<Vector3> vertices(3 * nbRefs), normals(3 * nbRefs);
+	for(int i = 0; i < nbRefs; i++)
+	{
+		triangles[i] = m_Triangles[indices[i]];
+		for(int k = 0; k < 3; k++)
+		{
+			vertices[3 * i + k] = m_Vertices[3 * indices[i] + k];
+			normals[3 * i + k] = m_Normals[3 * indices[i] + k];
+		}
+	}
+	m_Triangles.swap(triangles);
+	m_Vertices.swap(vertices);
+	m_Normals.swap(normals);
+	m_Order = indices;
+	m_WideBvh.Build(m_Bvh);
+}
+
+/**
+ * Gets the vertices of the mesh and the normals of its vertices, 3 per
+ * triangle in the order of AddTriangle.
+ */
+void Mesh::GetVertices(vector<Vector3>& vertices, vector<Vector3>& normals) const
+{
+	vertices.resize(3 * m_NbTriangles);
+	normals.resize(3 * m_NbTriangles);
+	for(size_t i = 0; i < m_Order.size(); i++)
+	{
+		for(int k = 0; k < 3; k++)
+		{
+			vertices[3 * m_Order[i] + k] = m_Vertices[3 * i + k];
+			normals[3 * m_Order[i] + k] = m_Normals[3 * i + k];
+		}
+	}
+}
+
+/**
+ * Moves the vertices of a built mesh, keeping its triangles. Refit must be
+ * called afterwards.
+ * @param vertices new vertices, 3 per triangle in the order of AddTriangle.
+ * @param normals new normals of the vertices, in the same order.
+ */
+void Mesh::SetVertices(const vector<Vector3>& vertices, const vector<Vector3>& normals)
+{
+	for(size_t i = 0; i < m_Order.size(); i++)
+	{
+		const int j = 3 * m_Order[i];
+		SetTriangleData(m_Triangles[i], vertices[j], vertices[j + 1], vertices[j + 2]);
+		for(int k = 0; k < 3; k++)
+		{
+			m_Vertices[3 * i + k] = vertices[j + k];
+			m_Normals[3 * i + k] = normals[j + k];
+		}
+	}
+}
+
+/**
+ * Updates the bounds of the BVH after the vertices moved, keeping its tree
+ * (the subtrees of the large meshes are refitted by several threads, see
+ * BVH::Refit), and collapses it again into the 4-wide BVH. If its cost has degraded by more
+ * than GetMaxDegradation since the last build, the BVH is built again. The
+ * instances of the mesh must then update their bounds (see
+ * MeshInstance::UpdateBounds).
+ * @return true if the BVH was built again.
+ */
+bool Mesh::Refit()
+{
+	if(m_Bvh.IsEmpty())
+		return false;
+
+	// bounds in the order of the triangles given to the last build
+	vector<Box> bounds(m_NbTriangles);
+	for(size_t i = 0; i < m_Order.size(); i++)
+	{
+		Box& b = bounds[m_Order[i]];
+		b = Box();
+		for(int k = 0; k < 3; k++)
+			b.Extend(m_Vertices[3 * i + k]);
+	}
+	m_Bvh.Refit(bounds);
+
+	if(m_Bvh.GetDegradation() > m_MaxDegradation)
+	{
+		Build();
+		return true;
+	}
+	m_WideBvh.Build(m_Bvh);
+	return false;
+}
+
+/**
+ * Finds the nearest intersection between the triangles and a ray expressed in
+ * the space of the mesh.
+ * @param tmin the intersections nearer than tmin are ignored.
+ * @param triangle receives the index of the triangle hit (-1 if none).
+ * @param tmax the intersections farther than tmax are ignored, and so are
+ * the nodes of the BVH.
+ * @return tmax if no nearer intersection detected.
+ */
+float Mesh::Intersect(const Ray& ray, float tmin, int& triangle, float tmax) const
+{
+	TriangleLeafTest test(m_Triangles, tmin, tmax);
+	float dist = m_WideBvh.Intersect(ray, test, tmax);
+	triangle = test.m_nearestTriangle;
+	return dist;
+}
+
+/**
+ * @return the normal at the point pos of the triangle i, interpolated from the
+ * normals of its vertices (see Triangle::GetVertexNormal).
+ */
+Vector3 Mesh::GetVertexNormal(int i, const Vector3& pos) const
+{
+	const Vector3& N = m_Triangles[i].N;
+	float v, w;
+	if(!GetBarycentric(m_Vertices[3 * i], m_Vertices[3 * i + 1], m_Vertices[3 * i + 2], pos, v, w))
+		return N;
+
+	Vector3 vN = m_Normals[3 * i] * (1.0f - v - w) + m_Normals[3 * i + 1] * v
+		+ m_Normals[3 * i + 2] * w;
+	if(Dot(vN, N) < 0)
+		vN = -vN;
+	return vN;
+}
+
+MeshInstance::MeshInstance(Mesh* mesh, const Mat4x4& transform):
+	RTObject(NULLVECTOR3, MESH_INSTANCE),m_Mesh(mesh),m_hitTriangle(-1)
+{
+	// same material as the triangles of ImportASE
+	Color color = mesh->GetColor();
+	m_material.SetColor(color);
+	m_material.SetRefraction(0.0f);
+	m_material.SetDiffuse(0.8f);
+	SetTransform(transform);
+}
+
+/**
+ * Changes the transform of the instance. Like any change of geometry, the
+ * scene must be updated (see RayTracer::UpdateObject).
+ */
+void MeshInstance::SetTransform(const Mat4x4& transform)
+{
+	m_Transform = transform;
+	m_Inverse = transform.affineInverse();
+	m_pos = Vector3(transform._41, transform._42, transform._43);
+	UpdateBounds();
+}
+
+/**
+ * Computes the bounds of the instance again after its mesh was refitted (see
+ * Mesh::Refit). The scene must then be updated (see RayTracer::UpdateObject).
+ */
+void MeshInstance::UpdateBounds()
+{
+	// bounds of the 8 transformed corners of the bounds of the mesh
+	m_Bounds = Box();
+	if(m_Mesh->GetNbTriangles() == 0)
+		return;
+	Box bounds = m_Mesh->GetBounds();
+	const Vector3 corners[2] = {bounds.GetMin(), bounds.GetMax()};
+	for(int i = 0; i < 8; i++)
+	{
+		Vector3 p(corners[i & 1].x, corners[(i >> 1) & 1].y, corners[(i >> 2) & 1].z);
+		m_Bounds.Extend(p * m_Transform);
+	}
+}
+
+/**
+ * Finds the nearest intersection between the mesh and the specified ray. The
+ * direction of the ray is transformed without being normalized, so the
+ * distance found in the space of the mesh is the distance in world space.
+ * The nearest triangle hit by the ray is kept for the normal (see GetNormal).
+ * @param tmin the intersections nearer than tmin are ignored.
+ * @param tmax the intersections farther than tmax are ignored : the instance
+ * is skipped if its box is behind a nearer hit, and so are the farther nodes
+ * of the BVH of its mesh.
+ * @return tmax if no nearer intersection detected.
+ */
+float MeshInstance::IntersectInstance(const Ray& ray, float tmin, float tmax)
+{
+	// the instance may be tested again by the same ray (references of the
+	// instance in several leaves of the BVH of the scene)
+	if(m_rayID != ray.GetID())
+	{
+		m_rayID = ray.GetID();
+		m_hitTriangle = -1;
+	}
+	float tnear, tfar;
+	if(!m_Bounds.Intersect(ray, 0, tmax, tnear, tfar))
+		return tmax;
+
+	const Mat4x4& inv = m_Inverse;
+	Vector3 d = ray.GetDirection();
+	Vector3 origin = ray.GetOrigin() * inv;
+	Vector3 dir(d.x * inv._11 + d.y * inv._21 + d.z * inv._31,
+		d.x * inv._12 + d.y * inv._22 + d.z * inv._32,
+		d.x * inv._13 + d.y * inv._23 + d.z * inv._33);
+	Ray local(origin, dir, ray.GetID());
+	int triangle;
+	float dist = m_Mesh->Intersect(local, tmin, triangle, tmax);
+	if(triangle >= 0)
+		m_hitTriangle = triangle;
+	return dist;
+}
+
+/**
+ * @return the normal of the triangle hit by the last ray tested (see
+ * IntersectInstance), pos being the point hit.
+ */
+Vector3 MeshInstance::GetNormal(Vector3& pos)
+{
+	return (m_hitTriangle < 0) ? NULLVECTOR3 : TransformNormal(m_Mesh->GetNormal(m_hitTriangle));
+}
+
+/**
+ * @return the normal at the point pos interpolated from the normals of the
+ * vertices of the triangle hit by the last ray tested (see
+ * Triangle::GetVertexNormal).
+ */
+Vector3 MeshInstance::GetVertexNormal(const Vector3& pos) const
+{
+	if(m_hitTriangle < 0)
+		return NULLVECTOR3;
+	return TransformNormal(m_Mesh->GetVertexNormal(m_hitTriangle, pos * m_Inverse));
+}
+
+/**
+ * Checks if the transformed bounds of the mesh overlap the specified box.
+ */
+bool MeshInstance::IntersectBoundingBox(const Vector3& v1, const Vector3& v2)
+{
+	return m_Bounds.Overlaps(v1, v2);
+}
+
+void MeshInstance::Translate(const Vector3& offset)
+{
+	Mat4x4 transform = m_Transform;
+	transform._41 += offset.x;
+	transform._42 += offset.y;
+	transform._43 += offset.z;
+	SetTransform(transform);
+}
+
+/**
+ * Transforms a normal of the mesh into world space (by the transpose of the
+ * inverse transform, so the normals stay orthogonal to the surfaces).
+ */
+Vector3 MeshInstance::TransformNormal(const Vector3& N) const
+{
+	const Mat4x4& inv = m_Inverse;
+	return Vector3(N.x * inv._11 + N.y * inv._12 + N.z * inv._13,
+		N.x * inv._21 + N.y * inv._22 + N.z * inv._23,
+		N.x * inv._31 + N.y * inv._32 + N.z * inv._33);
+}
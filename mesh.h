@@ -0,0 +1,162 @@
+/**
+* File : mesh.h
+* Description : Triangle meshes shared by several instances. A mesh stores its
+* triangles once, in its own space, with a BVH over them (bottom level). Each
+* instance is an object of the scene placing the mesh with a transform ; the
+* grid of the scene references the instances (top level), and the rays are
+* transformed into the space of the mesh when they reach an instance. Unlike
+* the other objects, an instance is tested by the rays starting from it
+* (its triangles shadow each other) : only the hits closer than
+* MESH_SELF_DISTANCE are ignored.
+* The vertices of an animated mesh can be moved without building its BVH
+* again : the tree is kept and its bounds are refitted, until its cost has
+* degraded too much (see Mesh::Refit).
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef MESH_H
+#define MESH_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "rtObjects.h"
+#include "wideBvh.h"
+#include "primitives.h"
+
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------- CONSTS
+
+// maximum number of triangles in a leaf of the BVH of a mesh
+#define MESH_LEAF_SIZE 4
+
+// distance under which a ray starting from an instance doesn't hit it
+#define MESH_SELF_DISTANCE 1e-3f
+
+//----------------------------------------------------------------------- CLASS
+
+// ----------------------------------------------------------------------------
+// Clips the triangles of a mesh for the spatial splits of its BVH
+// ----------------------------------------------------------------------------
+
+class TriangleClipper : public BVHClipper
+{
+public:
+	TriangleClipper(const vector<Vector3>& vertices):m_Vertices(vertices){}
+
+	Box Clip(int prim, const Box& box) const
+	{
+		return ClipTriangle(m_Vertices[3 * prim], m_Vertices[3 * prim + 1],
+			m_Vertices[3 * prim + 2], box);
+	}
+
+private:
+	const vector<Vector3>& m_Vertices; // 3 per triangle
+};
+
+// ----------------------------------------------------------------------------
+// Geometry of a mesh (see Scene::LoadMesh)
+// ----------------------------------------------------------------------------
+
+class Mesh
+{
+public:
+	Mesh();
+
+	void AddTriangle(const Vector3 vertices[3], const Vector3 normals[3]);
+	void Build();
+	void GetVertices(vector<Vector3>& vertices, vector<Vector3>& normals) const;
+	void SetVertices(const vector<Vector3>& vertices, const vector<Vector3>& normals);
+	bool Refit();
+	float GetMaxDegradation() const { return m_MaxDegradation; }
+	void SetMaxDegradation(float degradation) { m_MaxDegradation = degradation; }
+
+	int GetNbTriangles() const { return m_NbTriangles; }
+	Box GetBounds() const { return m_Bvh.GetBounds(); }
+	BVHSplit GetSplitMethod() const { return m_Bvh.GetSplitMethod(); }
+	void SetSplitMethod(BVHSplit split) { m_Bvh.SetSplitMethod(split); }
+	const BVH& GetBVH() const { return m_Bvh; }
+	const Color& GetColor() const { return m_Color; }
+	void SetColor(const Color& color) { m_Color = color; }
+
+	float Intersect(const Ray& ray, float tmin, int& triangle,
+		float tmax = std::numeric_limits<float>::infinity()) const;
+	Vector3 GetNormal(int i) const { return m_Triangles[i].N; }
+	Vector3 GetVertexNormal(int i, const Vector3& pos) const;
+
+private:
+	// triangles ordered by the leaves of the BVH once built (the triangles
+	// split by BVH_SPLIT_SPATIAL are copied in each of their leaves), with
+	// their vertices and the normals of their vertices (3 per triangle)
+	vector<TriangleData> m_Triangles;
+	vector<Vector3> m_Vertices;
+	vector<Vector3> m_Normals;
+	// triangle of AddTriangle copied in each reference (see SetVertices)
+	vector<int> m_Order;
+	int m_NbTriangles;
+	TriangleClipper m_Clipper;
+	BVH m_Bvh;
+	WideBVH m_WideBvh; // collapsed from m_Bvh for the intersections
+	// degradation of the BVH above which Refit builds it again
+	float m_MaxDegradation;
+	// color of the material of the file
+	Color m_Color;
+};
+
+// ----------------------------------------------------------------------------
+// Mesh placed in the scene by a transform (object space to world space)
+// ----------------------------------------------------------------------------
+
+class MeshInstance : public RTObject
+{
+public:
+	MeshInstance(Mesh* mesh, const Mat4x4& transform);
+
+	Mesh* GetMesh() const { return m_Mesh; }
+	const Mat4x4& GetTransform() const { return m_Transform; }
+	void SetTransform(const Mat4x4& transform);
+	void UpdateBounds();
+
+	float IntersectInstance(const Ray& ray, float tmin = 0,
+		float tmax = std::numeric_limits<float>::infinity());
+	float Intersect(const Ray& ray) { return IntersectInstance(ray); }
+	Vector3 GetNormal(Vector3& pos);
+	Vector3 GetVertexNormal(const Vector3& pos) const;
+	bool IntersectBoundingBox(const Vector3& v1, const Vector3& v2);
+	Box GetBounds() const { return m_Bounds; }
+	void Translate(const Vector3& offset);
+
+private:
+	Vector3 TransformNormal(const Vector3& N) const;
+
+	Mesh* m_Mesh; // shared, owned by the scene
+	Mat4x4 m_Transform;
+	Mat4x4 m_Inverse; // world space to object space
+	Box m_Bounds; // world space bounds of the transformed mesh
+	// nearest triangle of the mesh hit by the ray m_rayID (-1 if none)
+	int m_hitTriangle;
+};
+
+//------------------------------------------------------------------- FUNCTIONS
+
+inline float Intersect(InstanceData& i, const Ray& r)
+{
+	i.rayID = r.GetID();
+	return i.instance->IntersectInstance(r);
+}
+
+/**
+ * The triangles of an instance are tested by the rays starting from it (see
+ * IntersectFrom in primitives.h). The parts of the mesh farther than the
+ * nearest hit found so far are not traversed.
+ */
+inline float IntersectFrom(InstanceData& i, const Ray& r, RTObject* origin, float tmax)
+{
+	i.rayID = r.GetID();
+	return i.instance->IntersectInstance(r, (i.object == origin) ? MESH_SELF_DISTANCE : 0, tmax);
+}
+
+#endif // MESH_H
@@ -0,0 +1,248 @@
+/**
+* File : primitives.h
+* Description : Compact storage of the primitives used while tracing rays.
+* The objects added to the scene are copied into contiguous arrays, one array
+* per type of primitive, so the intersection loops don't have to go through
+* the virtual methods of RTObject. Each entry keeps a pointer to the object it
+* was built from (to retrieve the material and the normal once a hit is found).
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef PRIMITIVES_H
+#define PRIMITIVES_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "rtObjects.h"
+#include "sphereCloud.h"
+
+//----------------------------------------------------------------------- TYPES
+
+class MeshInstance; // see mesh.h
+
+enum PrimitiveType
+{
+	PRIM_SPHERE = 0, // spheres and lights
+	PRIM_PLANE,
+	PRIM_TRIANGLE,
+	PRIM_CLOUD,
+	PRIM_INSTANCE, // instances of meshes
+	PRIM_TYPES // number of primitive types
+};
+
+struct SphereData
+{
+	Vector3 center;
+	float radius;
+	int rayID; // ID of the last ray that was tested for intersection
+	RTObject* object;
+};
+
+struct PlaneData
+{
+	Vector3 N;
+	float d;
+	int rayID;
+	RTObject* object;
+};
+
+struct TriangleData
+{
+	Vector3 A; // first vertex
+	Vector3 N; // triangle normal (not normalized)
+	// edges AB and AC projected on the plane (axis0, axis1)
+	Vector2 b, c;
+	float dU, dV; // denominators of the barycentric coordinates
+	int axis0, axis1;
+	int rayID;
+	RTObject* object;
+};
+
+struct CloudData
+{
+	SphereCloud* cloud; // the cloud has its own BVH
+	int rayID;
+	RTObject* object;
+};
+
+struct InstanceData
+{
+	MeshInstance* instance; // the mesh has its own BVH (see mesh.h)
+	int rayID;
+	RTObject* object;
+};
+
+//------------------------------------------------------------------- FUNCTIONS
+
+/**
+ * Finds the nearest intersection between a sphere and the specified ray.
+ * @return std::numeric_limits<float>::infinity() if no intersection detected.
+ * Otherwise the distance between the intersected object and the origin of the
+ * ray is returned.
+ */
+inline float IntersectSphere(const Vector3& center, float radius, const Ray& a_Ray)
+{
+	Vector3 dst = a_Ray.GetOrigin() - center;
+	Vector3 dirRay = a_Ray.GetDirection();
+
+	float a_Dist = std::numeric_limits<float>::infinity();
+	float b = -Dot( dst, dirRay );
+	float det = (b * b) - Dot( dst, dst ) + radius;
+	if (det > 0)
+	{
+		det = sqrtf( det );
+		float i1 = b - det;
+		float i2 = b + det;
+		if (i2 > 0)
+		{
+			if (i1 < 0)
+			{
+				if (i2 < a_Dist)
+				{
+					a_Dist = i2;
+				}
+			}
+			else
+			{
+				if (i1 < a_Dist)
+				{
+					a_Dist = i1;
+				}
+			}
+		}
+	}
+	return a_Dist;
+}
+
+/**
+ * Finds the intersection between a plane and the specified ray.
+ */
+inline float IntersectPlane(const Vector3& N, float D, const Ray& a_Ray)
+{
+	float d = Dot( N, a_Ray.GetDirection() );
+	if (d != 0)
+	{
+		// Non orthogonal
+		float dist = -(Dot( N, a_Ray.GetOrigin() ) + D) / d;
+		if(dist > 0)
+			return dist;
+	}
+	return std::numeric_limits<float>::infinity();
+}
+
+/**
+ * Fills the triangle data from the coordinates of the 3 vertices
+ */
+inline void SetTriangleData(TriangleData& t, const Vector3& A, const Vector3& B, const Vector3& C)
+{
+	Vector3 bt = B - A;
+	Vector3 ct = C - A;
+	t.A = A;
+	t.N = Cross(bt, ct); // AB.AC => clockwize
+
+	// Project the triangle on a plane which is not orthogonal to the triangle
+	if(bt.x == 0 && ct.x == 0)
+	{
+		t.axis0 = 1; t.axis1 = 2;
+	}
+	else if(bt.y == 0 && ct.y == 0)
+	{
+		t.axis0 = 0; t.axis1 = 2;
+	}
+	else
+	{
+		t.axis0 = 0; t.axis1 = 1;
+	}
+	t.b.Set(bt[t.axis0], bt[t.axis1]);
+	t.c.Set(ct[t.axis0], ct[t.axis1]);
+	t.dU = t.b.y*t.c.x - t.b.x*t.c.y;
+	t.dV = t.c.y*t.b.x - t.c.x*t.b.y;
+}
+
+/**
+ * Finds the intersection between a triangle and the specified ray.
+ * Implementation based on :
+ * http://www.devmaster.net/wiki/Ray-triangle_intersection
+ */
+inline float IntersectTriangle(const TriangleData& t, const Ray& a_Ray)
+{
+	Vector3 D = a_Ray.GetDirection();
+	float d = Dot(D, t.N);
+
+	if (d != 0)
+	{
+		Vector3 O = a_Ray.GetOrigin();
+		float dist = -(Dot(t.N, O-t.A)) / d;
+		if(dist > 0)
+		{
+			Vector3 pt = O + dist * D - t.A;
+			Vector2 p(pt[t.axis0], pt[t.axis1]);
+
+			float u = p.y*t.c.x - p.x*t.c.y;
+			if(t.dU != 0)
+				u /= t.dU;
+
+			float v = p.y*t.b.x - p.x*t.b.y;
+			if(t.dV != 0)
+				v /= t.dV;
+
+			if(u>=0 && v>=0 && (u+v)<=1)
+				return dist;
+		}
+	}
+	return std::numeric_limits<float>::infinity();
+}
+
+inline float Intersect(SphereData& s, const Ray& r)
+{
+	s.rayID = r.GetID();
+	return IntersectSphere(s.center, s.radius, r);
+}
+
+inline float Intersect(PlaneData& p, const Ray& r)
+{
+	p.rayID = r.GetID();
+	return IntersectPlane(p.N, p.d, r);
+}
+
+inline float Intersect(TriangleData& t, const Ray& r)
+{
+	t.rayID = r.GetID();
+	return IntersectTriangle(t, r);
+}
+
+inline float Intersect(CloudData& c, const Ray& r)
+{
+	c.rayID = r.GetID();
+	return c.cloud->IntersectCloud(r);
+}
+
+/**
+ * Intersection of a ray starting from the object origin : the primitives of
+ * this object are not tested (the ray would hit the point it starts from).
+ * @param tmax distance of the nearest hit found so far by the ray : the
+ * primitives testing many triangles skip those farther (see the InstanceData
+ * version in mesh.h).
+ */
+template <class T>
+inline float IntersectFrom(T& prim, const Ray& r, RTObject* origin, float tmax)
+{
+	if(prim.object == origin)
+		return std::numeric_limits<float>::infinity();
+	return Intersect(prim, r);
+}
+
+/**
+ * The spheres of a cloud are tested by the rays starting from it (they shadow
+ * and reflect each other) : only the hits closer than CLOUD_SELF_DISTANCE are
+ * ignored, which excludes the sphere the ray starts from.
+ */
+inline float IntersectFrom(CloudData& c, const Ray& r, RTObject* origin, float tmax)
+{
+	c.rayID = r.GetID();
+	return c.cloud->IntersectCloud(r, (c.object == origin) ? CLOUD_SELF_DISTANCE : 0);
+}
+
+#endif // PRIMITIVES_H
@@ -1,546 +1,1373 @@
-/**
-* File : rayTracer.cpp
-* Description : This is the main class for the raytracer.
-* It implements the raytracing algorithm that fires rays through the pixels
-* in the screen and recursively spawns new rays upon reflection or refraction
-* Different options can be enabled using pre-processor flags :
-* - SPATIAL_DIVISION : The spatial division algorithm implemented is described
-* 	in the following paper : "A faster voxel traversal algorithm for ray tracing"
-* 	by John Amanatides and Andrew Woo (can be downloaded from
-* 	http://www.devmaster.net/articles/raytracing_series/part4.php)
-* - ANTI_ALIASING : The anti-aliasing algorithm is based on the super-sampling
-* 	technique : the image is rendered at higher resolutions and an average
-* 	color value is calculated.
-* 
-* Comments : The algorithm used in this class is inspired from :
-* http://www.devmaster.net/articles/raytracing_series/part1.php
-*				  
-* Author(s) : ALucchi
-* Date of creation : 28/10/2007
-* Modification(s) :
-*/
-
-//-------------------------------------------------------------------- INCLUDES
-
-#include "rayTracer.h"
-#include "defs.h"
-#include "display.h"
-#include "Maths/Vector3.h"
-#include "scene.h"
-
-//--------------------------------------------------------------------- GLOBALS
-
-extern Display	*display;
-
-#define ANTI_ALIASING
-#define SPATIAL_DIVISION
-
-//--------------------------------------------------------------------- METHODS
-
-/**
- * Initialize method
- */
-void RayTracer::Init()
-{
-	m_rayID = 1;
-	
-	// screen plane in world space coordinates
-	m_WX1 = -4, m_WX2 = 4, m_WY1 = m_SY = 3, m_WY2 = -3;
-	// calculate deltas for interpolation
-	m_DX = (m_WX2 - m_WX1) / SCR_WIDTH;
-	m_DY = (m_WY2 - m_WY1) / SCR_HEIGHT;
-	m_SY += m_DY;
-	
-#ifdef SPATIAL_DIVISION	
-	m_Scene.BuildGrid();
-
-	float gridSize = GRIDSIZE;	
-	// precalculate size of a cell
-	m_CS = m_Scene.GetBox().GetSize()/gridSize;
-	// precalculate 1 / size of a cell
-	m_RCS = 1.0f / m_CS;
-#endif	
-}
-
-void RayTracer::AddObject(RTObject* o)
-{
-	m_Scene.AddObject(o);
-}
-
-/**
- * Finds the nearest intersection between the specified ray r and any object
- * in the scene.
- * @param r the ray that will be fired into the scene. 
- * @param origin The object specified by the origin pointer will not be tested.
- * @param nearestObj If an intersection is detected, nearestObj will point to
- * the intersected object. Otherwise, it will be 0.
- * @return std::numeric_limits<float>::infinity() if no intersection detected.
- * Otherwise the distance between the intersected object and the origin of the
- * ray is returned.
- */
-float RayTracer::GetDistance(const Ray& r, RTObject*& nearestObj, RTObject* origin)
-{
-	float nearestT = std::numeric_limits<float>::infinity();	
-	list<RTObject*>::iterator iObjects;
-	for( iObjects = m_Scene.GetObjects().begin(); iObjects != m_Scene.GetObjects().end(); iObjects++ )
-	{
-		if((*iObjects) != origin)
-		{
-			float distObj = (*iObjects)->Intersect(r);
-			if(distObj < nearestT)
-			{
-				nearestObj = (*iObjects);
-				nearestT = distObj;
-			}
-		}
-	}
-	return nearestT;
-}
-
-/**
-  * This algorithm should be used when the spatial division is activated !
- * Finds the nearest intersection between the specified ray r and any object
- * in the scene.
- * @param r the ray that will be fired into the scene. 
- * @param origin The object specified by the origin pointer will not be tested.
- * @param nearestObj If an intersection is detected, nearestObj will point to
- * the intersected object. Otherwise, it will be 0.
- * @return std::numeric_limits<float>::infinity() if no intersection detected.
- * Otherwise the distance between the intersected object and the origin of the
- * ray is returned.
- */
-float RayTracer::FindNearest(const Ray& a_Ray, RTObject*& nearestObj, RTObject* origin)
-{
-	float a_Dist=std::numeric_limits<float>::infinity();
-	Vector3 raydir, curpos;
-	Box boundingBox = m_Scene.GetBox();
-	curpos = a_Ray.GetOrigin();
-	raydir = a_Ray.GetDirection();
-	
-	// setup 3DDDA (double check reusability of primary ray data)
-	
-	// cell boundary
-	Vector3 cb;
-	// value of t at which the ray crosses the first vertical voxel boundary
-	Vector3 tmax;
-	// how far we must move along the ray to cross one cell
-	Vector3 tdelta;
-	Vector3 cell = (curpos - boundingBox.GetMin()) * m_RCS;
-	
-	// stepX and stepY are initialized to either 1 or -1 indicating whether X
-	// and Y are incremented or decremented as the ray crosses voxel boundaries	
-	int stepX, stepY, stepZ;
-	// end of the grid
-	int outX, outY, outZ;
-
-	// X, Y, Z are initialized to the starting voxel coordinates
-	int X = (int)cell.x;
-	int Y = (int)cell.y;
-	int Z = (int)cell.z;
-	if ((X < 0) || (X >= GRIDSIZE) || (Y < 0) || (Y >= GRIDSIZE) || (Z < 0) || (Z >= GRIDSIZE))
-		return a_Dist; // infinity
-		
-	if (raydir.x > 0)
-	{
-		stepX = 1;
-		outX = GRIDSIZE;
-		cb.x = boundingBox.GetMin().x + (X + 1) * m_CS.x;
-	}
-	else 
-	{
-		stepX = -1;
-		outX = -1;
-		cb.x = boundingBox.GetMin().x + X * m_CS.x;
-	}
-	if (raydir.y > 0.0f)
-	{
-		stepY = 1;
-		outY = GRIDSIZE;
-		cb.y = boundingBox.GetMin().y + (Y + 1) * m_CS.y; 
-	}
-	else 
-	{
-		stepY = -1;
-		outY = -1;
-		cb.y = boundingBox.GetMin().y + Y * m_CS.y;
-	}
-	if (raydir.z > 0.0f)
-	{
-		stepZ = 1;
-		outZ = GRIDSIZE;
-		cb.z = boundingBox.GetMin().z + (Z + 1) * m_CS.z;
-	}
-	else 
-	{
-		stepZ = -1;
-		outZ = -1;
-		cb.z = boundingBox.GetMin().z + Z * m_CS.z;
-	}
-	
-	float rxr, ryr, rzr;
-	if (raydir.x != 0)
-	{
-		rxr = 1.0f / raydir.x;
-		tmax.x = (cb.x - curpos.x) * rxr; 
-		tdelta.x = m_CS.x * stepX * rxr;
-	}
-	else
-		tmax.x = 1000000;
-	if (raydir.y != 0)
-	{
-		ryr = 1.0f / raydir.y;
-		tmax.y = (cb.y - curpos.y) * ryr; 
-		tdelta.y = m_CS.y * stepY * ryr;
-	}
-	else
-		tmax.y = 1000000;
-	if (raydir.z != 0)
-	{
-		rzr = 1.0f / raydir.z;
-		tmax.z = (cb.z - curpos.z) * rzr; 
-		tdelta.z = m_CS.z * stepZ * rzr;
-	}
-	else
-		tmax.z = 1000000;
-		
-	// start stepping
-	ObjectList* list = 0;
-	ObjectList** grid = m_Scene.GetGrid();
-	nearestObj = 0;
-	// trace primary ray :
-	// loop until either we find a voxel with a non-empty object list or
-	// we fall out of the end of the grid.
-	while (1)
-	{
-		//list = grid[X + Y * GRIDSIZE + Z * GRIDSIZE * GRIDSIZE];		
-		list = grid[X + (Y << GRIDSHIFT) + (Z << (GRIDSHIFT * 2))];
-		while (list)
-		{
-			RTObject* object = list->GetRTObject();
-			if(object!=origin)
-			{			
-				//if (object->GetRayID() != a_Ray.GetID())
-				//{			
-					float distObj = object->Intersect(a_Ray);
-					if(distObj < a_Dist)
-					{
-						a_Dist = distObj;
-						nearestObj = object;
-						goto testloop;
-					}
-				//}			
-			}
-			list = list->GetNext();
-		}
-		if (tmax.x < tmax.y)
-		{
-			if (tmax.x < tmax.z)
-			{
-				X = X + stepX;
-				if (X == outX) return -1;
-				tmax.x += tdelta.x;
-			}
-			else
-			{
-				Z = Z + stepZ;
-				if (Z == outZ) return -1;
-				tmax.z += tdelta.z;
-			}
-		}
-		else
-		{
-			if (tmax.y < tmax.z)
-			{
-				Y = Y + stepY;
-				if (Y == outY) return -1;
-				tmax.y += tdelta.y;
-			}
-			else
-			{
-				Z = Z + stepZ;
-				if (Z == outZ) return -1;
-				tmax.z += tdelta.z;
-			}
-		}
-	}
-testloop:
-	// the following loop is the same as the previous one with an extra comparison
-	while (1)
-	{
-		//list = grid[X + Y * GRIDSIZE + Z * GRIDSIZE * GRIDSIZE];		
-		list = grid[X + (Y << GRIDSHIFT) + (Z << (GRIDSHIFT * 2))];
-		while (list)
-		{
-			RTObject* object = list->GetRTObject();
-			if(object!=origin)
-			{		
-				if (object->GetRayID() != a_Ray.GetID())
-				{
-					float distObj = object->Intersect(a_Ray);
-					if(distObj < a_Dist)
-					{
-						a_Dist = distObj;
-						nearestObj = object;
-					}
-				}
-			}			
-			list = list->GetNext();
-		}
-		if (tmax.x < tmax.y)
-		{
-			if (tmax.x < tmax.z)
-			{
-				if (a_Dist < tmax.x) break; // extra test
-				X = X + stepX;
-				if (X == outX) break;
-				tmax.x += tdelta.x;
-			}
-			else
-			{
-				if (a_Dist < tmax.z) break;
-				Z = Z + stepZ;
-				if (Z == outZ) break;
-				tmax.z += tdelta.z;
-			}
-		}
-		else
-		{
-			if (tmax.y < tmax.z)
-			{
-				if (a_Dist < tmax.y) break;
-				Y = Y + stepY;
-				if (Y == outY) break;
-				tmax.y += tdelta.y;
-			}
-			else
-			{
-				if (a_Dist < tmax.z) break;
-				Z = Z + stepZ;
-				if (Z == outZ) break;
-				tmax.z += tdelta.z;
-			}
-		}
-	}
-	return a_Dist;
-}
-
-/**
- * Raytrace a specified ray into the scene.
- * @param ray is the ray that will be fired into the scene. 
- * @param color is the color of the pixel on the screen. A black color is
- * returned if no objects intersected.
- * @param depth specify the number of recursive calls until now
- * @param rIndex is the refraction index of the previous encountered material
- * @param origin is the object from which the ray has been traced (0 if the ray comes
- * from the eye). 
- * @return This method returns a null pointer if no object is intersected by the ray.
- */
-RTObject* RayTracer::RayTrace(const Ray& ray, Color& color, int depth, float rIndex, RTObject* origin)
-{
-	if(depth > MAX_RAYTRACE_DEPTH) return 0;
-
-	// Find nearest object
-	RTObject* nearestObj = 0;
-
-#ifdef SPATIAL_DIVISION
-	float distObj = FindNearest(ray,nearestObj, origin);
-#else
-	float distObj = GetDistance(ray,nearestObj, origin);
-#endif
-
-	if(nearestObj)
-	//if(distObj != std::numeric_limits<float>::infinity() && distObj>=0)
-	{
-		//if(nearestObj->GetType() == RTObject::LIGHT)
-		if(false) // debug to display the lights
-		{
-			color = nearestObj->GetMaterial()->GetColor();
-		}
-		else
-		{
-			Vector3 posObj = ray.GetOrigin() + ray.GetDirection() * distObj;
-			// Normal
-			Vector3 N = nearestObj->GetNormal(posObj);
-			N.Normalize();
-
-			// Shoot a ray to each light source to check if in shadow
-			list<RTObject*>::iterator iObjectLight;
-			for( iObjectLight = m_Scene.GetObjects().begin(); iObjectLight != m_Scene.GetObjects().end(); iObjectLight++ )
-			{
-				if((*iObjectLight)->GetType() == RTObject::LIGHT)
-				{					
-					Vector3 L = (*iObjectLight)->GetPosition()-posObj;
-					// Don't use L.Normalize() to speed things up as we need to get the lenght of L
-					float distL = L.Length();
-					if(distL > std::numeric_limits<float>::epsilon())
-						L *= 1/distL;
-					Ray rLight(posObj, L, m_rayID++);
-																						
-					RTObject* nearestObjL;			
-					#ifdef SPATIAL_DIVISION
-						float distObj = FindNearest(rLight, nearestObjL, nearestObj);
-					#else
-						float distObj = GetDistance(rLight, nearestObjL, nearestObj);
-					#endif
-
-					if(nearestObjL == *iObjectLight)
-					{
-						// No shadow as there is no object between the
-						// intersected object and the light
-						float angleNL = Dot(N,L);
-						if(angleNL > 0)
-						{
-							color += nearestObj->GetMaterial()->GetColor()*angleNL*nearestObj->GetMaterial()->GetDiffuse()*(*iObjectLight)->GetMaterial()->GetColor();
-						}
-
-						if (nearestObj->GetMaterial()->GetSpecular() > 0)
-						{
-							// point light source: sample once for specular highlight
-							Vector3 V = ray.GetDirection();
-							Vector3 R = L - 2.0f * Dot( L, N ) * N;
-							float dotVR = Dot( V, R );
-							if (dotVR > 0)
-							{
-								float spec = powf( dotVR, 20 ) * nearestObj->GetMaterial()->GetSpecular();
-								// add specular component to ray color
-								color += ((*iObjectLight)->GetMaterial()->GetColor() * spec);
-							}
-						}
-					}
-				}
-			}			
-			// calculate reflection
-			float reflection = nearestObj->GetMaterial()->GetReflection();
-			if (reflection > 0.0f)
-			{
-				Vector3 R = ray.GetDirection() - 2.0f * Dot( ray.GetDirection(), N ) * N;
-				Ray reflRay(posObj, R, m_rayID++);
-
-				Color rcol;
-				// Instead of passing a pointer to the origin object, we could move
-				// the ray a little bit doing : posObj+(R*EPSILON)
-				RayTrace(reflRay, rcol, depth + 1, rIndex, nearestObj);
-				color += rcol * reflection * nearestObj->GetMaterial()->GetColor();
-			}
-			// calculate refraction using Snell's law
-			float refraction = nearestObj->GetMaterial()->GetRefraction();
-			if (refraction > 0.0f)
-			{
-				float new_rIndex = nearestObj->GetMaterial()->GetRefrIndex();
-				float n = rIndex / new_rIndex;
-				if(distObj<0)
-					N = -N;
-				float cosI = -Dot( N, ray.GetDirection() );
-				float cosT2 = 1.0f - n * n * (1.0f - cosI * cosI);
-				if (cosT2 > 0.0f)
-				{
-					Vector3 T = (n * ray.GetDirection()) + (n * cosI - sqrtf( cosT2 )) * N;
-					Ray refrRay(posObj, T, m_rayID++);
-					Color rcol;
-					RayTrace(refrRay, rcol, depth + 1, new_rIndex, nearestObj);
-					color += rcol * refraction;
-				}
-			}		
-		}
-	}
-
-	return nearestObj;
-}
-
-/**
- * Render the scene. The eye vector is the position from which the viewer sees
- * the scene.
- */
-void RayTracer::Render()
-{
-	Screen screen=display->GetScreen();
-	
-#ifdef SPATIAL_DIVISION	
-	Box bb = m_Scene.GetBox();
-#endif	
-
-#ifdef ANTI_ALIASING
-	RTObject* lastObject = 0;
-	RTObject* lineObject[SCR_WIDTH];
-#endif
-
-	// For each pixel in the image
-	for(int h=0;h<SCR_HEIGHT;h++)	
-	{
-		m_SX = m_WX1;
-		for(int w=0;w<SCR_WIDTH;w++)
-		{
-			// Create ray from eyepoint passing through this pixel
-			Vector3 o(m_SX,m_SY,0);
-			Vector3 dirEye = o-eye;
-			dirEye.Normalize();
-			Ray rEye(eye,dirEye,m_rayID);
-			m_rayID++;
-
-#ifdef SPATIAL_DIVISION
-			// advance ray to scene bounding box boundary
-			if (!bb.Contains(o))
-			{
-				float bbDist;
-				if (bbDist=bb.Intersect(rEye))
-				{
-					Vector3 origin = o+(bbDist + EPSILON) * dirEye;
-					rEye.SetOrigin(origin);
-				}
-			}
-#endif
-
-			Color color;
-			RTObject* object = RayTrace(rEye,color,0,1,0);			
-
-			int red, green, blue;
-			
-#ifdef ANTI_ALIASING
-			// super-sampling only when we encounter a new primitive
-			if(lastObject != object || lineObject[w] != object)
-			{
-				lastObject = object;
-				lineObject[w] = object;
-				
-				for ( int tx = -1; tx < 2; tx++ )
-					for ( int ty = -1; ty < 2; ty++ )
-					{
-						Vector3 dir = Vector3( m_SX + m_DX * tx / 2.0f, m_SY + m_DY * ty / 2.0f, 0 ) - eye;
-						dir.Normalize();
-						Ray r(eye, dir, m_rayID++);
-						RayTrace(r,color,0,1,0);
-					}				
-				
-				red = (int)(color.x * 256.0f/9.0f);
-				green = (int)(color.y * 256.0f/9.0f);
-				blue = (int)(color.z * 256.0f/9.0f);				
-			}
-			else
-#endif
-			{				
-				red = (int)(color.x * 256.0f);
-				green = (int)(color.y * 256.0f);
-				blue = (int)(color.z * 256.0f);
-			}
-			
-			if(red > 255)	red = 255;
-			if(green > 255)	green = 255;
-			if(blue > 255)	blue = 255;
-
-			*screen = (red << 16) + (green << 8) + blue;
-			m_SX += m_DX;
-			screen++;	
-		}
-		m_SY += m_DY;
-	}	
-}
-
-/**
- * Imports the ASE model contained in the file whose name is specified in
- * strFileName
- * @param strFileName file name that contains the ASE model to be imported
- */
-void RayTracer::ImportASE(char *strFileName)
-{
-	m_Scene.ImportASE(strFileName);
-}
+/**
+* File : rayTracer.cpp
+* Description : This is the main class for the raytracer.
+* It implements the raytracing algorithm that fires rays through the pixels
+* in the screen and spawns new rays upon reflection or refraction. The
+* secondary rays are kept in an explicit stack instead of being traced
+* recursively, so the maximum depth can be changed at run time. Secondary
+* rays whose contribution to the pixel falls under a threshold are not traced
+* (or only randomly if the russian roulette is enabled).
+* Several views of the scene (stereo pairs, several cameras) can be rendered
+* in one job sharing the scene and the grid (see RenderViews). After the
+* material of objects has been edited, only the tiles showing them are
+* rendered again (see Invalidate and RenderChanges). Objects can be inserted,
+* removed and moved after Init without building the grid again (see
+* InsertObject). A model can be placed many times while its triangles are
+* stored once (see LoadMesh).
+* Different options can be selected for each render (see SetRenderFlags) :
+* - RENDER_SPATIAL_DIVISION : The spatial division algorithm implemented is described
+* 	in the following paper : "A faster voxel traversal algorithm for ray tracing"
+* 	by John Amanatides and Andrew Woo (can be downloaded from
+* 	http://www.devmaster.net/articles/raytracing_series/part4.php)
+* - RENDER_ANTI_ALIASING : The anti-aliasing algorithm is based on the super-sampling
+* 	technique : the image is rendered at higher resolutions and an average
+* 	color value is calculated.
+* - RENDER_ADAPTIVE_AA : adaptive super-sampling : the pixels contrasting with
+* 	their neighbors are recursively subdivided as long as the colors of the
+* 	corners of the sub-squares differ (see SetAdaptiveDepth and
+* 	SetContrastThreshold).
+* - RENDER_POST_AA : no additional ray, the edges are smoothed on the final
+* 	image (see EdgeFilter).
+* - RENDER_VERTEX_NORMALS : the normals of the triangles are interpolated
+* 	from the normals of their vertices.
+* - RENDER_PROGRESSIVE : the image is first traced for one pixel out of a
+* 	block of pixels and shown with the color of this pixel for the whole
+* 	block, then refined in passes halving the size of the blocks (see
+* 	SetProgressiveBlock). The pixels traced by a pass are not traced again.
+* - RENDER_REPROJECTION : the primary hits of the last frame are reprojected
+* 	into the new one, their pixels are shaded without searching the nearest
+* 	object nor tracing the shadow rays again (see ReprojectionCache).
+* The options (except RENDER_PROGRESSIVE and RENDER_REPROJECTION) are
+* template parameters of the render and trace methods : each combination is
+* compiled separately, without any test in the loops, and the one matching
+* the flags is called through a table.
+* 
+* Comments : The algorithm used in this class is inspired from :
+* http://www.devmaster.net/articles/raytracing_series/part1.php
+*				  
+* Author(s) : ALucchi
+* Date of creation : 28/10/2007
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+
+#include "rayTracer.h"
+#include "defs.h"
+#include "display.h"
+#include "Maths/Vector3.h"
+#include "scene.h"
+
+#include <algorithm>
+
+//--------------------------------------------------------------------- GLOBALS
+
+extern Display	*display;
+
+// instantiations of the render methods, indexed by the anti-aliasing mode and
+// by the other flags
+#define RENDER_FUNCTIONS(AA) \
+	{ \
+		&RayTracer::RenderImage<AA, false, false>, \
+		&RayTracer::RenderImage<AA, true, false>, \
+		&RayTracer::RenderImage<AA, false, true>, \
+		&RayTracer::RenderImage<AA, true, true> \
+	}
+
+const RayTracer::RenderFunction RayTracer::s_RenderFunctions[RENDER_AA_MODES]
+	[RENDER_PROGRESSIVE / RENDER_SPATIAL_DIVISION] =
+{
+	RENDER_FUNCTIONS(RENDER_NO_AA),
+	RENDER_FUNCTIONS(RENDER_ANTI_ALIASING),
+	RENDER_FUNCTIONS(RENDER_ADAPTIVE_AA),
+	RENDER_FUNCTIONS(RENDER_POST_AA)
+};
+
+// same without the anti-aliasing mode
+const RayTracer::TraceFunction RayTracer::s_TraceFunctions[RENDER_PROGRESSIVE / RENDER_SPATIAL_DIVISION] =
+{
+	&RayTracer::Trace<false, false>,
+	&RayTracer::Trace<true, false>,
+	&RayTracer::Trace<false, true>,
+	&RayTracer::Trace<true, true>
+};
+
+//--------------------------------------------------------------------- HELPERS
+
+/**
+ * @return the largest difference between the components of two colors. The
+ * components are saturated at 1 like on the screen.
+ */
+static inline float Contrast(const Color& a, const Color& b)
+{
+	float dr = fabsf(std::min(a.x, 1.0f) - std::min(b.x, 1.0f));
+	float dg = fabsf(std::min(a.y, 1.0f) - std::min(b.y, 1.0f));
+	float db = fabsf(std::min(a.z, 1.0f) - std::min(b.z, 1.0f));
+	return std::max(dr, std::max(dg, db));
+}
+
+/**
+ * @return true if one of the corners of a square contrasts with its center.
+ */
+static inline bool HasContrast(const Color corners[4], const Color& center, float threshold)
+{
+	for(int i = 0; i < 4; i++)
+	{
+		if(Contrast(corners[i], center) > threshold)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Sets the bit of an object in a record of nbWords words (see
+ * FrameBuffer::GetTileObjects). The objects added after the record was reset
+ * are ignored.
+ */
+static inline void MarkObject(unsigned int* objects, int nbWords, const RTObject* object)
+{
+	int i = object->GetIndex();
+	if(i >= 0 && (i >> 5) < nbWords)
+		objects[i >> 5] |= 1u << (i & 31);
+}
+
+/**
+ * Tests the ray against every primitive of an array.
+ * The loop is instantiated for each type of primitive, so the intersection
+ * code is inlined instead of going through a virtual call.
+ */
+template <class T>
+static inline void IntersectAll(vector<T>& prims, const Ray& r, float& nearestT,
+	RTObject*& nearestObj, RTObject* origin)
+{
+	for(size_t i = 0; i < prims.size(); i++)
+	{
+		T& prim = prims[i];
+		float distObj = IntersectFrom(prim, r, origin, nearestT);
+		if(distObj < nearestT)
+		{
+			nearestObj = prim.object;
+			nearestT = distObj;
+		}
+	}
+}
+
+/**
+ * Tests the ray against the primitives of one type referenced by a grid cell.
+ * The primitives already tested with the same ray in a previous cell are
+ * skipped (mailboxing).
+ */
+template <class T>
+static inline void IntersectCell(vector<T>& prims, const vector<int>& refs, const Ray& r,
+	float& nearestT, RTObject*& nearestObj, RTObject* origin)
+{
+	for(size_t i = 0; i < refs.size(); i++)
+	{
+		T& prim = prims[refs[i]];
+		if(prim.rayID != r.GetID())
+		{
+			float distObj = IntersectFrom(prim, r, origin, nearestT);
+			if(distObj < nearestT)
+			{
+				nearestObj = prim.object;
+				nearestT = distObj;
+			}
+		}
+	}
+}
+
+/**
+ * Intersects the primitives of a leaf of the BVH of the scene (see
+ * BVH::Intersect) and keeps the object of the nearest one.
+ */
+struct SceneLeafTest
+{
+	Scene& m_Scene;
+	const vector<int>& m_Indices;
+	const vector<PrimRef>& m_Prims;
+	RTObject* m_origin;
+	float m_nearest; // distance of m_nearestObj
+	RTObject* m_nearestObj;
+
+	SceneLeafTest(Scene& scene, RTObject* origin, float nearest, RTObject* nearestObj):
+		m_Scene(scene),m_Indices(scene.GetBVH().GetIndices()),m_Prims(scene.GetBVHPrims()),
+		m_origin(origin),m_nearest(nearest),m_nearestObj(nearestObj){}
+	float operator()(int first, int count, const Ray& r)
+	{
+		for(int i = first; i < first + count; i++)
+		{
+			const PrimRef& ref = m_Prims[m_Indices[i]];
+			switch(ref.type)
+			{
+				case PRIM_SPHERE:	Test(m_Scene.GetSpheres()[ref.prim], r);	break;
+				case PRIM_TRIANGLE:	Test(m_Scene.GetTriangles()[ref.prim], r);	break;
+				case PRIM_CLOUD:	Test(m_Scene.GetClouds()[ref.prim], r);		break;
+				case PRIM_INSTANCE:	Test(m_Scene.GetInstances()[ref.prim], r);	break;
+			}
+		}
+		return m_nearest;
+	}
+	template <class T>
+	void Test(T& prim, const Ray& r)
+	{
+		float distObj = IntersectFrom(prim, r, m_origin, m_nearest);
+		if(distObj < m_nearest)
+		{
+			m_nearestObj = prim.object;
+			m_nearest = distObj;
+		}
+	}
+};
+
+//--------------------------------------------------------------------- METHODS
+
+/**
+ * Initialize method
+ */
+void RayTracer::Init()
+{
+	m_rayID = 1;
+	
+	m_Scene.BuildPrimitives();
+	
+	// the grid is always built so that the spatial division can be selected
+	// for any render
+	m_Scene.BuildGrid();
+	if(m_Scene.GetAcceleration() == ACCEL_BVH)
+		m_Scene.BuildBVH();
+
+	m_Changed.assign(m_Scene.GetNbIndices() / 32 + 1, 0);
+
+	float gridSize = GRIDSIZE;	
+	// precalculate size of a cell
+	m_CS = m_Scene.GetBox().GetSize()/gridSize;
+	// precalculate 1 / size of a cell
+	m_RCS = 1.0f / m_CS;
+}
+
+/**
+ * Set the maximum depth of the ray tree (0 means that only the primary rays
+ * are traced). The depth is clamped so that the pending rays always fit in
+ * the stack used by RayTrace.
+ */
+void RayTracer::SetMaxDepth(int depth)
+{
+	if(depth < 0)
+		depth = 0;
+	if(depth > RAY_STACK_SIZE - 1)
+		depth = RAY_STACK_SIZE - 1;
+	m_maxDepth = depth;
+}
+
+/**
+ * Selects the options of the next renders (combination of RenderFlags). An
+ * unknown anti-aliasing mode disables the anti-aliasing. Toggling
+ * RENDER_REPROJECTION clears the hits of the last frame.
+ */
+void RayTracer::SetRenderFlags(int flags)
+{
+	flags &= RENDER_COMBINATIONS - 1;
+	if((flags & RENDER_AA_MASK) >= RENDER_AA_MODES)
+		flags &= ~RENDER_AA_MASK;
+	if((flags ^ m_renderFlags) & RENDER_REPROJECTION)
+		m_Reprojection.Clear();
+	m_renderFlags = flags;
+}
+
+/**
+ * Set the maximum number of times the adaptive anti-aliasing subdivides a
+ * pixel (0 only averages the corners and the center of the pixels).
+ */
+void RayTracer::SetAdaptiveDepth(int depth)
+{
+	if(depth < 0)
+		depth = 0;
+	if(depth > MAX_ADAPTIVE_AA_DEPTH)
+		depth = MAX_ADAPTIVE_AA_DEPTH;
+	m_aaDepth = depth;
+}
+
+/**
+ * Set the size of the blocks of pixels of the first pass of a progressive
+ * render. The size is rounded down to a power of two between 1 (no coarse
+ * pass) and the size of a tile.
+ */
+void RayTracer::SetProgressiveBlock(int size)
+{
+	int block = 1;
+	while(block * 2 <= size && block * 2 <= TILE_SIZE)
+		block *= 2;
+	m_progressiveBlock = block;
+}
+
+/**
+ * Returns a pseudo-random number in [0,1) (xorshift generator).
+ */
+float RayTracer::Random()
+{
+	m_seed ^= m_seed << 13;
+	m_seed ^= m_seed >> 17;
+	m_seed ^= m_seed << 5;
+	return (m_seed >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * Decides if a secondary ray is worth tracing.
+ * @param weight is the contribution of the ray to the pixel color. If the
+ * russian roulette is enabled and the ray survives, the weight is scaled up so
+ * that the expected value of the color stays the same.
+ * @return true if the ray must be traced.
+ */
+bool RayTracer::KeepRay(Color& weight)
+{
+	float w = weight.x;
+	if(weight.y > w) w = weight.y;
+	if(weight.z > w) w = weight.z;
+	
+	if(w >= m_minWeight)
+		return true;
+	
+	if(m_russianRoulette && w > 0)
+	{
+		// survival probability proportional to the weight
+		float p = w / m_minWeight;
+		if(Random() < p)
+		{
+			weight *= 1.0f / p;
+			return true;
+		}
+	}
+	m_stats.culledRays++;
+	return false;
+}
+
+void RayTracer::AddObject(RTObject* o)
+{
+	m_Scene.AddObject(o);
+}
+
+/**
+ * Adds an object to the scene after Init : only the cells of the grid covered
+ * by the bounds of the object are updated. The hits of the previous frame
+ * can't be reused (see GetReprojectionCache) and the next frame must be
+ * rendered by Render (RenderChanges only handles edited materials).
+ */
+void RayTracer::InsertObject(RTObject* o)
+{
+	m_Scene.InsertObject(o);
+	m_Changed.resize(m_Scene.GetNbIndices() / 32 + 1, 0);
+	m_Reprojection.Clear();
+}
+
+/**
+ * Removes an object from the scene after Init (see InsertObject). The object
+ * isn't deleted.
+ */
+void RayTracer::RemoveObject(RTObject* o)
+{
+	m_Scene.RemoveObject(o);
+	m_Reprojection.Clear();
+}
+
+/**
+ * Moves an object of the scene after Init : only the cells covered by its
+ * old and its new position are updated (see InsertObject).
+ */
+void RayTracer::MoveObject(RTObject* o, const Vector3& offset)
+{
+	o->Translate(offset);
+	UpdateObject(o);
+}
+
+/**
+ * Updates the grid after the geometry of an object was modified (deformed
+ * sphere cloud,...) : only the cells covered by its old and its new bounds
+ * are updated (see InsertObject).
+ */
+void RayTracer::UpdateObject(RTObject* o)
+{
+	m_Scene.UpdateObject(o);
+	m_Reprojection.Clear();
+}
+
+/**
+ * Finds the nearest intersection between the specified ray r and any object
+ * in the scene.
+ * @param r the ray that will be fired into the scene. 
+ * @param origin The object specified by the origin pointer will not be tested.
+ * @param nearestObj If an intersection is detected, nearestObj will point to
+ * the intersected object. Otherwise, it will be 0.
+ * @return std::numeric_limits<float>::infinity() if no intersection detected.
+ * Otherwise the distance between the intersected object and the origin of the
+ * ray is returned.
+ */
+float RayTracer::GetDistance(const Ray& r, RTObject*& nearestObj, RTObject* origin)
+{
+	float nearestT = std::numeric_limits<float>::infinity();	
+	nearestObj = 0;
+	IntersectAll(m_Scene.GetSpheres(), r, nearestT, nearestObj, origin);
+	IntersectAll(m_Scene.GetPlanes(), r, nearestT, nearestObj, origin);
+	IntersectAll(m_Scene.GetTriangles(), r, nearestT, nearestObj, origin);
+	IntersectAll(m_Scene.GetClouds(), r, nearestT, nearestObj, origin);
+	IntersectAll(m_Scene.GetInstances(), r, nearestT, nearestObj, origin);
+	return nearestT;
+}
+
+/**
+  * This algorithm should be used when the spatial division is activated !
+ * Finds the nearest intersection between the specified ray r and any object
+ * in the scene, by stepping through the grid or by traversing the BVH of the
+ * scene (see Scene::SetAcceleration). In the grid, the empty cells far from
+ * any primitive are skipped several at a time (see GridCell::m_Distance).
+ * @param r the ray that will be fired into the scene. 
+ * @param origin The object specified by the origin pointer will not be tested.
+ * @param nearestObj If an intersection is detected, nearestObj will point to
+ * the intersected object. Otherwise, it will be 0.
+ * @return std::numeric_limits<float>::infinity() if no intersection detected.
+ * Otherwise the distance between the intersected object and the origin of the
+ * ray is returned.
+ */
+float RayTracer::FindNearest(const Ray& a_Ray, RTObject*& nearestObj, RTObject* origin)
+{
+	if(m_Scene.GetAcceleration() == ACCEL_BVH)
+	{
+		// the planes have no bounds, they are tested before the BVH
+		float nearestT = std::numeric_limits<float>::infinity();
+		nearestObj = 0;
+		IntersectAll(m_Scene.GetPlanes(), a_Ray, nearestT, nearestObj, origin);
+		SceneLeafTest test(m_Scene, origin, nearestT, nearestObj);
+		nearestT = m_Scene.GetWideBVH().Intersect(a_Ray, test, nearestT);
+		nearestObj = test.m_nearestObj;
+		return nearestT;
+	}
+
+	float a_Dist=std::numeric_limits<float>::infinity();
+	nearestObj = 0;
+	Vector3 raydir, curpos;
+	Box boundingBox = m_Scene.GetBox();
+	curpos = a_Ray.GetOrigin();
+	raydir = a_Ray.GetDirection();
+	
+	// setup 3DDDA (double check reusability of primary ray data)
+	
+	// cell boundary
+	Vector3 cb;
+	// value of t at which the ray crosses the first vertical voxel boundary
+	Vector3 tmax;
+	// how far we must move along the ray to cross one cell
+	Vector3 tdelta;
+	Vector3 cell = (curpos - boundingBox.GetMin()) * m_RCS;
+	
+	// stepX and stepY are initialized to either 1 or -1 indicating whether X
+	// and Y are incremented or decremented as the ray crosses voxel boundaries	
+	int stepX, stepY, stepZ;
+	// end of the grid
+	int outX, outY, outZ;
+
+	// X, Y, Z are initialized to the starting voxel coordinates
+	int X = (int)cell.x;
+	int Y = (int)cell.y;
+	int Z = (int)cell.z;
+	if ((X < 0) || (X >= GRIDSIZE) || (Y < 0) || (Y >= GRIDSIZE) || (Z < 0) || (Z >= GRIDSIZE))
+		return a_Dist; // infinity
+		
+	if (raydir.x > 0)
+	{
+		stepX = 1;
+		outX = GRIDSIZE;
+		cb.x = boundingBox.GetMin().x + (X + 1) * m_CS.x;
+	}
+	else 
+	{
+		stepX = -1;
+		outX = -1;
+		cb.x = boundingBox.GetMin().x + X * m_CS.x;
+	}
+	if (raydir.y > 0.0f)
+	{
+		stepY = 1;
+		outY = GRIDSIZE;
+		cb.y = boundingBox.GetMin().y + (Y + 1) * m_CS.y; 
+	}
+	else 
+	{
+		stepY = -1;
+		outY = -1;
+		cb.y = boundingBox.GetMin().y + Y * m_CS.y;
+	}
+	if (raydir.z > 0.0f)
+	{
+		stepZ = 1;
+		outZ = GRIDSIZE;
+		cb.z = boundingBox.GetMin().z + (Z + 1) * m_CS.z;
+	}
+	else 
+	{
+		stepZ = -1;
+		outZ = -1;
+		cb.z = boundingBox.GetMin().z + Z * m_CS.z;
+	}
+	
+	float rxr, ryr, rzr;
+	if (raydir.x != 0)
+	{
+		rxr = a_Ray.GetInvDirection().x;
+		tmax.x = (cb.x - curpos.x) * rxr; 
+		tdelta.x = m_CS.x * stepX * rxr;
+	}
+	else
+	{
+		tmax.x = 1000000;
+		tdelta.x = 0;
+	}
+	if (raydir.y != 0)
+	{
+		ryr = a_Ray.GetInvDirection().y;
+		tmax.y = (cb.y - curpos.y) * ryr; 
+		tdelta.y = m_CS.y * stepY * ryr;
+	}
+	else
+	{
+		tmax.y = 1000000;
+		tdelta.y = 0;
+	}
+	if (raydir.z != 0)
+	{
+		rzr = a_Ray.GetInvDirection().z;
+		tmax.z = (cb.z - curpos.z) * rzr; 
+		tdelta.z = m_CS.z * stepZ * rzr;
+	}
+	else
+	{
+		tmax.z = 1000000;
+		tdelta.z = 0;
+	}
+		
+	// start stepping
+	GridCell* grid = m_Scene.GetGrid();
+	vector<SphereData>& spheres = m_Scene.GetSpheres();
+	vector<PlaneData>& planes = m_Scene.GetPlanes();
+	vector<TriangleData>& triangles = m_Scene.GetTriangles();
+	vector<CloudData>& clouds = m_Scene.GetClouds();
+	vector<InstanceData>& instances = m_Scene.GetInstances();
+	// loop until either we find an intersection inside the current voxel or
+	// we fall out of the end of the grid.
+	while (1)
+	{
+		//GridCell& cell = grid[X + Y * GRIDSIZE + Z * GRIDSIZE * GRIDSIZE];
+		GridCell& cell = grid[X + (Y << GRIDSHIFT) + (Z << (GRIDSHIFT * 2))];
+		if (cell.m_Distance > 1)
+		{
+			// the cells nearer than m_Distance are empty : the ray jumps to
+			// the first cell after the cube of these cells. It leaves the cube
+			// when it crosses its last boundary along one of the axes.
+			int skip = cell.m_Distance - 1;
+			float texit = std::min(std::min(tmax.x + skip * tdelta.x, tmax.y + skip * tdelta.y),
+				tmax.z + skip * tdelta.z);
+			// no hit in the empty cells, nor in the cells after them
+			if (a_Dist < texit) break;
+			int nX = 0, nY = 0, nZ = 0;
+			while (nX <= skip && tmax.x + nX * tdelta.x <= texit) nX++;
+			while (nY <= skip && tmax.y + nY * tdelta.y <= texit) nY++;
+			while (nZ <= skip && tmax.z + nZ * tdelta.z <= texit) nZ++;
+			X += nX * stepX;
+			Y += nY * stepY;
+			Z += nZ * stepZ;
+			if (X < 0 || X >= GRIDSIZE || Y < 0 || Y >= GRIDSIZE || Z < 0 || Z >= GRIDSIZE) break;
+			tmax.x += nX * tdelta.x;
+			tmax.y += nY * tdelta.y;
+			tmax.z += nZ * tdelta.z;
+			continue;
+		}
+		IntersectCell(spheres, cell.m_Prims[PRIM_SPHERE], a_Ray, a_Dist, nearestObj, origin);
+		IntersectCell(planes, cell.m_Prims[PRIM_PLANE], a_Ray, a_Dist, nearestObj, origin);
+		IntersectCell(triangles, cell.m_Prims[PRIM_TRIANGLE], a_Ray, a_Dist, nearestObj, origin);
+		IntersectCell(clouds, cell.m_Prims[PRIM_CLOUD], a_Ray, a_Dist, nearestObj, origin);
+		IntersectCell(instances, cell.m_Prims[PRIM_INSTANCE], a_Ray, a_Dist, nearestObj, origin);
+
+		// An intersection found in this cell can be closer than the ones of
+		// the next cells. We must stop only when it lies inside the cell.
+		if (tmax.x < tmax.y)
+		{
+			if (tmax.x < tmax.z)
+			{
+				if (a_Dist < tmax.x) break;
+				X = X + stepX;
+				if (X == outX) break;
+				tmax.x += tdelta.x;
+			}
+			else
+			{
+				if (a_Dist < tmax.z) break;
+				Z = Z + stepZ;
+				if (Z == outZ) break;
+				tmax.z += tdelta.z;
+			}
+		}
+		else
+		{
+			if (tmax.y < tmax.z)
+			{
+				if (a_Dist < tmax.y) break;
+				Y = Y + stepY;
+				if (Y == outY) break;
+				tmax.y += tdelta.y;
+			}
+			else
+			{
+				if (a_Dist < tmax.z) break;
+				Z = Z + stepZ;
+				if (Z == outZ) break;
+				tmax.z += tdelta.z;
+			}
+		}
+	}
+	return a_Dist;
+}
+
+/**
+ * Raytrace a specified ray into the scene with the options selected by
+ * SetRenderFlags (see Trace).
+ */
+RTObject* RayTracer::RayTrace(const Ray& ray, Color& color)
+{
+	return (this->*s_TraceFunctions[(m_renderFlags & (RENDER_PROGRESSIVE - 1))
+		/ RENDER_SPATIAL_DIVISION])(ray, color);
+}
+
+/**
+ * Raytrace a specified ray into the scene.
+ * @param ray is the ray that will be fired into the scene. 
+ * @param color is the color of the pixel on the screen. The color computed for
+ * the ray is added to it (it is left unchanged if no objects intersected).
+ * @return This method returns a null pointer if no object is intersected by the ray.
+ */
+template <bool SpatialDivision, bool VertexNormals>
+RTObject* RayTracer::Trace(const Ray& ray, Color& color)
+{
+	PrimaryHit hit;
+	TracePrimary<SpatialDivision, VertexNormals>(ray, color, hit, false);
+	return hit.object;
+}
+
+/**
+ * Raytrace a primary ray into the scene.
+ * The reflected and refracted rays are not traced recursively : they are
+ * pushed on a small explicit stack of pending rays, each one carrying the
+ * weight (throughput) with which its color contributes to the final color.
+ * The local colors are added multiplied by this weight instead of the
+ * recursive rcol * reflection * color, and the secondary rays take their ids
+ * in another order : the colors may differ from the recursive version in the
+ * last bits.
+ * @param color receives the color of the ray as in Trace.
+ * @param hit receives the point hit by the ray. If reuse is true, it holds
+ * a point of the last frame (see ReprojectionCache) : if the ray hits its
+ * object, the visibility of the lights stored with it is reused instead of
+ * tracing the shadow rays. Otherwise the ray is traced normally.
+ */
+template <bool SpatialDivision, bool VertexNormals>
+void RayTracer::TracePrimary(const Ray& ray, Color& color, PrimaryHit& hit, bool reuse)
+{
+	PendingRay stack[RAY_STACK_SIZE];
+	int nbPending = 0;
+
+	stack[nbPending++] = PendingRay(ray, WHITE, 0, 1.0f, 0);
+
+	while(nbPending > 0)
+	{
+		const PendingRay current = stack[--nbPending];
+		const Ray& cRay = current.ray;
+		const bool primary = current.depth == 0;
+
+		// Find nearest object
+		RTObject* nearestObj = 0;
+		float distObj = 0;
+
+		if(primary && reuse)
+		{
+			// only the object seen in the last frame is tested
+			nearestObj = hit.object;
+			distObj = nearestObj->Intersect(cRay);
+			reuse = distObj < std::numeric_limits<float>::infinity();
+		}
+		if(!(primary && reuse))
+		{
+			distObj = SpatialDivision ? FindNearest(cRay, nearestObj, current.origin)
+				: GetDistance(cRay, nearestObj, current.origin);
+		}
+
+		if(!nearestObj)
+		{
+			if(primary)
+				hit = PrimaryHit();
+			continue;
+		}
+		if(m_Touched)
+			MarkObject(m_Touched, m_TouchedWords, nearestObj);
+
+		RTMaterial* material = nearestObj->GetMaterial();
+		Vector3 posObj = cRay.GetOrigin() + cRay.GetDirection() * distObj;
+		// Normal
+		Vector3 N;
+		if(VertexNormals && nearestObj->GetType() == RTObject::TRIANGLE)
+			N = ((Triangle*)nearestObj)->GetVertexNormal(posObj);
+		else if(VertexNormals && nearestObj->GetType() == RTObject::MESH_INSTANCE)
+			N = ((MeshInstance*)nearestObj)->GetVertexNormal(posObj);
+		else
+			N = nearestObj->GetNormal(posObj);
+		N.Normalize();
+
+		if(primary)
+		{
+			if(reuse)
+			{
+				hit.age++;
+				m_stats.reprojected++;
+			}
+			else
+			{
+				hit.object = nearestObj;
+				hit.lights = 0;
+				hit.age = 0;
+			}
+			hit.position = posObj;
+		}
+
+		// local color of the intersected point, weighted at the end
+		Color local;
+
+		// Shoot a ray to each light source to check if in shadow
+		vector<RTObject*>::iterator iObjectLight;
+		unsigned int bit = 1; // bit of the light in PrimaryHit::lights (0 after 32 lights)
+		for( iObjectLight = m_Scene.GetLights().begin(); iObjectLight != m_Scene.GetLights().end(); iObjectLight++, bit <<= 1 )
+		{
+			Vector3 L = (*iObjectLight)->GetPosition()-posObj;
+			// Don't use L.Normalize() to speed things up as we need to get the lenght of L
+			float distL = L.Length();
+			if(distL > std::numeric_limits<float>::epsilon())
+				L *= 1/distL;
+
+			bool visible;
+			if(primary && reuse && bit)
+				visible = (hit.lights & bit) != 0;
+			else
+			{
+				Ray rLight(posObj, L, m_rayID++);
+				m_stats.shadowRays++;
+																					
+				RTObject* nearestObjL;			
+				if(SpatialDivision)
+					FindNearest(rLight, nearestObjL, nearestObj);
+				else
+					GetDistance(rLight, nearestObjL, nearestObj);
+
+				visible = nearestObjL == *iObjectLight;
+				if(primary && visible)
+					hit.lights |= bit;
+			}
+
+			if(visible)
+			{
+				if(m_Touched)
+					MarkObject(m_Touched, m_TouchedWords, *iObjectLight);
+				// No shadow as there is no object between the
+				// intersected object and the light
+				float angleNL = Dot(N,L);
+				if(angleNL > 0)
+				{
+					local += material->GetColor()*angleNL*material->GetDiffuse()*(*iObjectLight)->GetMaterial()->GetColor();
+				}
+
+				if (material->GetSpecular() > 0)
+				{
+					// point light source: sample once for specular highlight
+					Vector3 V = cRay.GetDirection();
+					Vector3 R = L - 2.0f * Dot( L, N ) * N;
+					float dotVR = Dot( V, R );
+					if (dotVR > 0)
+					{
+						float spec = powf( dotVR, 20 ) * material->GetSpecular();
+						// add specular component to ray color
+						local += ((*iObjectLight)->GetMaterial()->GetColor() * spec);
+					}
+				}
+			}
+		}
+
+		color += local * current.weight;
+
+		// No secondary rays beyond the maximum depth
+		if(current.depth >= m_maxDepth)
+			continue;
+
+		// calculate refraction using Snell's law
+		// (pushed before the reflected ray so that the reflected one is
+		// traced first, as it used to be with the recursive version)
+		float refraction = material->GetRefraction();
+		if (refraction > 0.0f)
+		{
+			float new_rIndex = material->GetRefrIndex();
+			float n = current.rIndex / new_rIndex;
+			Vector3 NR = (distObj<0) ? -N : N;
+			float cosI = -Dot( NR, cRay.GetDirection() );
+			float cosT2 = 1.0f - n * n * (1.0f - cosI * cosI);
+			Color weight = current.weight * refraction;
+			if (cosT2 > 0.0f && KeepRay(weight))
+			{
+				Vector3 T = (n * cRay.GetDirection()) + (n * cosI - sqrtf( cosT2 )) * NR;
+				stack[nbPending++] = PendingRay(Ray(posObj, T, m_rayID++),
+					weight, current.depth + 1, new_rIndex, nearestObj);
+				m_stats.secondaryRays++;
+			}
+		}
+		// calculate reflection
+		float reflection = material->GetReflection();
+		Color weight = current.weight * reflection * material->GetColor();
+		if (reflection > 0.0f && KeepRay(weight))
+		{
+			Vector3 R = cRay.GetDirection() - 2.0f * Dot( cRay.GetDirection(), N ) * N;
+			// Instead of passing a pointer to the origin object, we could move
+			// the ray a little bit doing : posObj+(R*EPSILON)
+			stack[nbPending++] = PendingRay(Ray(posObj, R, m_rayID++),
+				weight, current.depth + 1, current.rIndex, nearestObj);
+			m_stats.secondaryRays++;
+		}
+	}
+}
+
+/**
+ * Render the scene as seen by the camera of the ray tracer (see GetCamera) and
+ * show it on the display. With RENDER_REPROJECTION, the hits of the last frame
+ * are reused (see GetReprojectionCache).
+ */
+void RayTracer::Render()
+{
+	View view(&m_Camera, &m_FrameBuffer,
+		(m_renderFlags & RENDER_REPROJECTION) ? &m_Reprojection : 0);
+	RenderViews(&view, 1);
+	m_FrameBuffer.Convert(display->GetScreen(), SCR_WIDTH, SCR_HEIGHT);
+}
+
+/**
+ * Render the scene for several cameras at once (stereo pairs, several points
+ * of view of the same scene) with the options selected by SetRenderFlags. The
+ * tiles of the views are interleaved. The frames are not shown. The views
+ * having a cache reuse the hits of their last frame.
+ * If the frame budget is enabled, the resolution, the anti-aliasing and the
+ * depth of the ray tree are those of the level of quality chosen by the
+ * budget, and the render time is measured to choose the level of the next
+ * frame.
+ */
+void RayTracer::RenderViews(const View* views, int nbViews)
+{
+	Uint32 start = SDL_GetTicks();
+	int flags = m_renderFlags;
+	int maxDepth = m_maxDepth;
+	int aaDepth = m_aaDepth;
+
+	int width = SCR_WIDTH, height = SCR_HEIGHT;
+	if(m_Budget.IsEnabled())
+	{
+		// the settings of the level replace those of the user for this frame
+		const QualityLevel& quality = m_Budget.GetQuality();
+		width = std::max((int)(SCR_WIDTH * quality.resolution + 0.5f), 1);
+		height = std::max((int)(SCR_HEIGHT * quality.resolution + 0.5f), 1);
+		m_renderFlags = (flags & ~RENDER_AA_MASK) | quality.antiAliasing;
+		SetMaxDepth(quality.maxDepth);
+		SetAdaptiveDepth(quality.aaDepth);
+	}
+	for(int v = 0; v < nbViews; v++)
+	{
+		views[v].frame->Resize(width, height);
+		views[v].frame->ResetTileObjects(m_Scene.GetNbIndices());
+		views[v].camera->SetResolution(width, height);
+		if(views[v].cache)
+			views[v].cache->Reproject(*views[v].camera, width, height);
+	}
+
+	(this->*s_RenderFunctions[m_renderFlags & RENDER_AA_MASK]
+		[(m_renderFlags & (RENDER_PROGRESSIVE - 1)) / RENDER_SPATIAL_DIVISION])(views, nbViews);
+
+	m_Touched = 0;
+	for(int v = 0; v < nbViews; v++)
+	{
+		if(views[v].cache)
+			views[v].cache->Store(*views[v].frame);
+	}
+
+	m_stats.width = width;
+	m_stats.height = height;
+	m_stats.quality = -1;
+	if(m_Budget.IsEnabled())
+	{
+		m_renderFlags = flags;
+		m_maxDepth = maxDepth;
+		m_aaDepth = aaDepth;
+		m_stats.quality = m_Budget.GetLevel();
+		m_Budget.Update((float)(SDL_GetTicks() - start));
+	}
+}
+
+/**
+ * Marks an object whose material has been edited since the last frame (see
+ * RenderChanges). The objects not added to the scene before Init are ignored.
+ */
+void RayTracer::Invalidate(RTObject* object)
+{
+	int i = object->GetIndex();
+	if(i >= 0 && (size_t)(i >> 5) < m_Changed.size())
+		m_Changed[i >> 5] |= 1u << (i & 31);
+}
+
+/**
+ * Render again the tiles of the last frame of Render whose rays touched an
+ * object marked by Invalidate and show them on the display. The adaptive
+ * anti-aliasing compares the pixels with their neighbors : the tiles around
+ * them are rendered too. With the frame budget, the whole frame is rendered
+ * again (its resolution may change). The hits of the last frame are cleared
+ * (see GetReprojectionCache).
+ * @return the number of tiles rendered.
+ */
+int RayTracer::RenderChanges()
+{
+	// nothing to render again before Init
+	if(m_Changed.empty())
+		return 0;
+
+	FrameBuffer& frame = m_FrameBuffer;
+	const int nbTiles = frame.GetNbTiles();
+	vector<char> tiles(nbTiles, 0);
+	int nbChanged = 0;
+	for(int i = 0; i < nbTiles; i++)
+	{
+		if(frame.TouchesObjects(i, &m_Changed[0], (int)m_Changed.size()))
+		{
+			tiles[i] = 1;
+			nbChanged++;
+		}
+	}
+	std::fill(m_Changed.begin(), m_Changed.end(), 0u);
+	if(nbChanged == 0)
+		return 0;
+	m_Reprojection.Clear();
+
+	if(m_Budget.IsEnabled())
+	{
+		Render();
+		return nbTiles;
+	}
+
+	const int aa = m_renderFlags & RENDER_AA_MASK;
+	if(aa == RENDER_ADAPTIVE_AA)
+	{
+		const int nbTilesX = frame.GetNbTilesX();
+		vector<char> changed(tiles);
+		for(int i = 0; i < nbTiles; i++)
+		{
+			if(!changed[i])
+				continue;
+			int tx = i % nbTilesX, ty = i / nbTilesX;
+			for(int y = std::max(ty - 1, 0); y <= ty + 1; y++)
+			{
+				for(int x = std::max(tx - 1, 0); x <= std::min(tx + 1, nbTilesX - 1); x++)
+				{
+					if(x + y * nbTilesX < nbTiles)
+						tiles[x + y * nbTilesX] = 1;
+				}
+			}
+		}
+	}
+
+	nbChanged = 0;
+	for(int i = 0; i < nbTiles; i++)
+	{
+		if(tiles[i])
+		{
+			frame.ClearTileObjects(i);
+			nbChanged++;
+		}
+	}
+
+	// no coarse pass, the rest of the frame is already shown
+	View view(&m_Camera, &frame);
+	int flags = m_renderFlags;
+	m_renderFlags &= ~RENDER_PROGRESSIVE;
+	m_Tiles = &tiles;
+	(this->*s_RenderFunctions[aa]
+		[(m_renderFlags & (RENDER_PROGRESSIVE - 1)) / RENDER_SPATIAL_DIVISION])(&view, 1);
+	m_Tiles = 0;
+	m_Touched = 0;
+	m_renderFlags = flags;
+
+	// the edge filter may change the pixels around the tiles
+	if(aa == RENDER_POST_AA || frame.GetWidth() != SCR_WIDTH || frame.GetHeight() != SCR_HEIGHT)
+		frame.Convert(display->GetScreen(), SCR_WIDTH, SCR_HEIGHT);
+	else
+	{
+		for(int i = 0; i < nbTiles; i++)
+		{
+			if(tiles[i])
+				frame.ConvertTile(display->GetScreen(), frame.GetTile(i));
+		}
+	}
+	return nbChanged;
+}
+
+/**
+ * Render the views. The scene is first brought up to date with the edits made
+ * since the last render (see Scene::Refresh). A primary ray is first fired
+ * through the center of each pixel, then the pixels selected by the
+ * anti-aliasing mode are super-sampled.
+ * In a progressive render, the primary rays are fired in several passes and
+ * the frame of the first view is shown after each of them.
+ */
+template <int AntiAliasing, bool SpatialDivision, bool VertexNormals>
+void RayTracer::RenderImage(const View* views, int nbViews)
+{
+	m_Scene.Refresh();
+	m_stats.Reset();
+	const int nbJobs = GetNbJobs(views, nbViews);
+	Tile tile;
+
+	if(m_renderFlags & RENDER_PROGRESSIVE)
+	{
+		for(int step = m_progressiveBlock; step > 0; step /= 2)
+		{
+			for(int i = 0; i < nbJobs; i++)
+			{
+				if(StartJob(views, nbViews, i, tile))
+					RenderTile<SpatialDivision, VertexNormals>(tile, step, step < m_progressiveBlock);
+			}
+			if(step > 1 || AntiAliasing != RENDER_NO_AA)
+				PresentFrame(*views[0].frame);
+		}
+	}
+	else
+	{
+		for(int i = 0; i < nbJobs; i++)
+		{
+			if(StartJob(views, nbViews, i, tile))
+				RenderTile<SpatialDivision, VertexNormals>(tile, 1, false);
+		}
+	}
+
+	if(AntiAliasing == RENDER_ANTI_ALIASING)
+	{
+		for(int i = 0; i < nbJobs; i++)
+		{
+			if(StartJob(views, nbViews, i, tile))
+				AntiAliasTile<SpatialDivision, VertexNormals>(tile);
+		}
+	}
+	else if(AntiAliasing == RENDER_ADAPTIVE_AA)
+	{
+		for(int i = 0; i < nbJobs; i++)
+		{
+			if(StartJob(views, nbViews, i, tile))
+				AdaptiveTile<SpatialDivision, VertexNormals>(tile);
+		}
+	}
+	else if(AntiAliasing == RENDER_POST_AA)
+	{
+		for(int v = 0; v < nbViews; v++)
+		{
+			// the tiles not rendered again have already been filtered
+			if(m_Tiles)
+				views[v].frame->RestoreColors();
+			m_EdgeFilter.Apply(*views[v].frame);
+		}
+	}
+}
+
+/**
+ * @return the number of jobs of a pass over the tiles of the views : the
+ * job i renders the tile i / nbViews of the view i % nbViews.
+ */
+int RayTracer::GetNbJobs(const View* views, int nbViews) const
+{
+	int nbTiles = 0;
+	for(int v = 0; v < nbViews; v++)
+		nbTiles = std::max(nbTiles, views[v].frame->GetNbTiles());
+	return nbTiles * nbViews;
+}
+
+/**
+ * Selects the view of a job (see GetNbJobs).
+ * @param tile receives the tile of the job.
+ * @return false if the view has no such tile or if the tile isn't rendered
+ * again (see RenderChanges).
+ */
+bool RayTracer::StartJob(const View* views, int nbViews, int job, Tile& tile)
+{
+	m_View = &views[job % nbViews];
+	int i = job / nbViews;
+	if(i >= m_View->frame->GetNbTiles() || (m_Tiles && !(*m_Tiles)[i]))
+		return false;
+	tile = m_View->frame->GetTile(i);
+	m_Touched = m_View->frame->GetTileObjects(i);
+	m_TouchedWords = m_View->frame->GetObjectWords();
+	return true;
+}
+
+/**
+ * Shows a frame rendered so far (the last frame is flipped by the caller of
+ * Render).
+ */
+void RayTracer::PresentFrame(const FrameBuffer& frame)
+{
+	frame.Convert(display->GetScreen(), SCR_WIDTH, SCR_HEIGHT);
+	display->Flip();
+}
+
+/**
+ * @return the ray fired from the camera in a direction given by the camera
+ * (see Camera::GetDirection).
+ */
+template <bool SpatialDivision>
+Ray RayTracer::GetPrimaryRay(Vector3 dirEye)
+{
+	Vector3 eye = m_View->camera->GetPosition();
+	dirEye.Normalize();
+	Ray rEye(eye,dirEye,m_rayID++);
+	m_stats.primaryRays++;
+
+	// advance ray to scene bounding box boundary
+	Box& bb = m_Scene.GetBox();
+	if (SpatialDivision && !bb.Contains(eye))
+	{
+		float bbDist = bb.Intersect(rEye);
+		if (bbDist < std::numeric_limits<float>::infinity())
+		{
+			Vector3 origin = eye+(bbDist + EPSILON) * dirEye;
+			rEye.SetOrigin(origin);
+		}
+	}
+	return rEye;
+}
+
+/**
+ * @return the color seen through the point (x, y) of the frame, in pixels.
+ */
+template <bool SpatialDivision, bool VertexNormals>
+Color RayTracer::Sample(float x, float y)
+{
+	Color color;
+	Trace<SpatialDivision, VertexNormals>(
+		GetPrimaryRay<SpatialDivision>(m_View->camera->GetDirection(x, y)), color);
+	return color;
+}
+
+/**
+ * @return the sample (X, Y) of the lattice of the SampleCache, traced if it
+ * isn't in the cache yet.
+ */
+template <bool SpatialDivision, bool VertexNormals>
+const Color& RayTracer::GetLatticeSample(int X, int Y)
+{
+	const Color* sample = m_SampleCache.Get(X, Y);
+	if(!sample)
+	{
+		Color color;
+		Trace<SpatialDivision, VertexNormals>(
+			GetPrimaryRay<SpatialDivision>(m_View->camera->GetLatticeDirection(X, Y)), color);
+		m_SampleCache.Set(X, Y, color);
+		sample = m_SampleCache.Get(X, Y);
+	}
+	return *sample;
+}
+
+/**
+ * Fires the primary rays of the pixels of a tile whose coordinates are
+ * multiples of step. Each traced pixel gives its color to the block of
+ * step x step pixels it starts. The pixels having a candidate in the cache of
+ * the view are shaded from it (see TracePrimary).
+ * @param refine the pixels whose coordinates are multiples of 2 * step have
+ * already been traced by the previous pass : they are skipped.
+ */
+template <bool SpatialDivision, bool VertexNormals>
+void RayTracer::RenderTile(const Tile& tile, int step, bool refine)
+{
+	FrameBuffer& frame = *m_View->frame;
+	const int coarse = 2 * step;
+	for(int y = tile.y0; y < tile.y1; y += step)
+	{
+		for(int x = tile.x0; x < tile.x1; x += step)
+		{
+			if(refine && x % coarse == 0 && y % coarse == 0)
+				continue;
+
+			Color color;
+			PrimaryHit hit;
+			const PrimaryHit* candidate = m_View->cache ? m_View->cache->GetCandidate(x, y) : 0;
+			if(candidate)
+				hit = *candidate;
+			TracePrimary<SpatialDivision, VertexNormals>(
+				GetPrimaryRay<SpatialDivision>(m_View->camera->GetLatticeDirection(2 * x, 2 * y)),
+				color, hit, candidate != 0);
+			frame.SetSample(x, y, color, hit);
+			if(step > 1)
+				frame.FillBlock(x, y, step, color);
+		}
+	}
+}
+
+/**
+ * Super-samples the pixels of a tile whose object differs from the object of
+ * the pixel on their left or above them. Such a pixel gets the average color
+ * of 9 samples : its primary sample, the middles of its edges and its corners.
+ * The samples shared with the neighbors are traced only once.
+ */
+template <bool SpatialDivision, bool VertexNormals>
+void RayTracer::AntiAliasTile(const Tile& tile)
+{
+	FrameBuffer& frame = *m_View->frame;
+	m_SampleCache.Reset(tile);
+	for(int y = tile.y0; y < tile.y1; y++)
+	{
+		for(int x = tile.x0; x < tile.x1; x++)
+		{
+			RTObject* object = frame.GetObject(x, y);
+			if((x == 0 || frame.GetObject(x - 1, y) == object) &&
+				(y == 0 || frame.GetObject(x, y - 1) == object))
+				continue;
+
+			Color color = frame.GetSample(x, y);
+			for(int ty = -1; ty < 2; ty++)
+			{
+				for(int tx = -1; tx < 2; tx++)
+				{
+					if(tx == 0 && ty == 0)
+						continue;
+					color += GetLatticeSample<SpatialDivision, VertexNormals>(2 * x + tx, 2 * y + ty);
+				}
+			}
+			frame.SetColor(x, y, color * (1.0f / 9.0f));
+		}
+	}
+}
+
+/**
+ * Adaptive super-sampling of the pixels of a tile. Only the pixels whose
+ * primary sample contrasts with the primary sample of a neighbor are
+ * sampled : their corners are traced and the pixel is subdivided if they
+ * contrast with its center (see SampleSquare). The corners and the middles of
+ * the edges of the pixels are shared with the neighbors.
+ */
+template <bool SpatialDivision, bool VertexNormals>
+void RayTracer::AdaptiveTile(const Tile& tile)
+{
+	FrameBuffer& frame = *m_View->frame;
+	const int width = frame.GetWidth();
+	const int height = frame.GetHeight();
+
+	m_SampleCache.Reset(tile);
+	for(int y = tile.y0; y < tile.y1; y++)
+	{
+		for(int x = tile.x0; x < tile.x1; x++)
+		{
+			const Color& center = frame.GetSample(x, y);
+			if((x == 0 || Contrast(frame.GetSample(x - 1, y), center) <= m_aaThreshold) &&
+				(x == width - 1 || Contrast(frame.GetSample(x + 1, y), center) <= m_aaThreshold) &&
+				(y == 0 || Contrast(frame.GetSample(x, y - 1), center) <= m_aaThreshold) &&
+				(y == height - 1 || Contrast(frame.GetSample(x, y + 1), center) <= m_aaThreshold))
+				continue;
+
+			const int X = 2 * x, Y = 2 * y;
+			const Color corners[4] =
+			{
+				GetLatticeSample<SpatialDivision, VertexNormals>(X - 1, Y - 1),
+				GetLatticeSample<SpatialDivision, VertexNormals>(X + 1, Y - 1),
+				GetLatticeSample<SpatialDivision, VertexNormals>(X - 1, Y + 1),
+				GetLatticeSample<SpatialDivision, VertexNormals>(X + 1, Y + 1)
+			};
+
+			Color color;
+			if(m_aaDepth == 0 || !HasContrast(corners, center, m_aaThreshold))
+				color = (corners[0] + corners[1] + corners[2] + corners[3] + center) * 0.2f;
+			else
+			{
+				const Color edges[4] =
+				{
+					GetLatticeSample<SpatialDivision, VertexNormals>(X, Y - 1),
+					GetLatticeSample<SpatialDivision, VertexNormals>(X - 1, Y),
+					GetLatticeSample<SpatialDivision, VertexNormals>(X + 1, Y),
+					GetLatticeSample<SpatialDivision, VertexNormals>(X, Y + 1)
+				};
+				color = Subdivide<SpatialDivision, VertexNormals>((float)x, (float)y, 0.5f,
+					corners, edges, center, 0);
+			}
+			frame.SetColor(x, y, color);
+		}
+	}
+}
+
+/**
+ * @return the color of the square of center (x, y) and half size h (in
+ * pixels). The square is subdivided if one of its corners contrasts with its
+ * center, otherwise its color is the average of its corners and its center.
+ * @param corners colors of the top left, top right, bottom left and bottom
+ * right corners.
+ * @param depth number of subdivisions that led to this square.
+ */
+template <bool SpatialDivision, bool VertexNormals>
+Color RayTracer::SampleSquare(float x, float y, float h, const Color corners[4],
+	const Color& center, int depth)
+{
+	if(depth >= m_aaDepth || !HasContrast(corners, center, m_aaThreshold))
+		return (corners[0] + corners[1] + corners[2] + corners[3] + center) * 0.2f;
+
+	const Color edges[4] =
+	{
+		Sample<SpatialDivision, VertexNormals>(x, y - h),
+		Sample<SpatialDivision, VertexNormals>(x - h, y),
+		Sample<SpatialDivision, VertexNormals>(x + h, y),
+		Sample<SpatialDivision, VertexNormals>(x, y + h)
+	};
+	return Subdivide<SpatialDivision, VertexNormals>(x, y, h, corners, edges, center, depth);
+}
+
+/**
+ * @return the average color of the four quarters of a square (see
+ * SampleSquare).
+ * @param edges colors of the middles of the top, left, right and bottom edges.
+ */
+template <bool SpatialDivision, bool VertexNormals>
+Color RayTracer::Subdivide(float x, float y, float h, const Color corners[4],
+	const Color edges[4], const Color& center, int depth)
+{
+	const float q = h * 0.5f;
+	const Color topLeft[4] = {corners[0], edges[0], edges[1], center};
+	const Color topRight[4] = {edges[0], corners[1], center, edges[2]};
+	const Color bottomLeft[4] = {edges[1], center, corners[2], edges[3]};
+	const Color bottomRight[4] = {center, edges[2], edges[3], corners[3]};
+
+	Color color = SampleSquare<SpatialDivision, VertexNormals>(x - q, y - q, q, topLeft,
+		Sample<SpatialDivision, VertexNormals>(x - q, y - q), depth + 1);
+	color += SampleSquare<SpatialDivision, VertexNormals>(x + q, y - q, q, topRight,
+		Sample<SpatialDivision, VertexNormals>(x + q, y - q), depth + 1);
+	color += SampleSquare<SpatialDivision, VertexNormals>(x - q, y + q, q, bottomLeft,
+		Sample<SpatialDivision, VertexNormals>(x - q, y + q), depth + 1);
+	color += SampleSquare<SpatialDivision, VertexNormals>(x + q, y + q, q, bottomRight,
+		Sample<SpatialDivision, VertexNormals>(x + q, y + q), depth + 1);
+	return color * 0.25f;
+}
+
+/**
+ * Imports the ASE model contained in the file whose name is specified in
+ * strFileName
+ * @param strFileName file name that contains the ASE model to be imported
+ */
+void RayTracer::ImportASE(char *strFileName)
+{
+	m_Scene.ImportASE(strFileName);
+}
+
+/**
+ * Loads an ASE model once to place it with MeshInstance objects (see
+ * Scene::LoadMesh). The spatial splits are only worth it for the meshes made
+ * of long and thin triangles.
+ */
+Mesh* RayTracer::LoadMesh(const char* strFileName, BVHSplit split)
+{
+	return m_Scene.LoadMesh(strFileName, split);
+}
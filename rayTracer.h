@@ -1,74 +1,294 @@
-/**
-* File : rayTracer.h
-* Description : This is the main class for the raytracer.
-* It implements the raytracing algorithm that fires rays through the pixels
-* in the screen and recursively spawns new rays upon reflection or refraction
-* Different options can be enabled using pre-processor flags :
-* - SPATIAL_DIVISION : The spatial division algorithm implemented is described
-* 	in the following paper : "A faster voxel traversal algorithm for ray tracing"
-* 	by John Amanatides and Andrew Woo (can be downloaded from
-* 	http://www.devmaster.net/articles/raytracing_series/part4.php)
-* - ANTI_ALIASING : The anti-aliasing algorithm is based on the super-sampling
-* 	technique : the image is rendered at higher resolutions and an average
-* 	color value is calculated.
-* 
-* Comments : The algorithm used in this class is inspired from :
-* http://www.devmaster.net/articles/raytracing_series/part1.php
-*				  
-* Author(s) : ALucchi
-* Date of creation : 28/10/2007
-* Modification(s) :
-*/
-
-#ifndef RAYTRACER_H
-#define RAYTRACER_H
-
-//-------------------------------------------------------------------- INCLUDES
-#include "rtObjects.h"
-#include "scene.h"
-#include "Maths/math3D.h"
-
-//---------------------------------------------------------------------- CONSTS
-
-#define MAX_RAYTRACE_DEPTH 3
-
-static Vector3 eye(0,2,-10);
-
-//----------------------------------------------------------------------- CLASS
-
-// ----------------------------------------------------------------------------
-// RayTracer class
-// ----------------------------------------------------------------------------
-
-class RayTracer
-{
-private:	
-
-	int m_rayID; // counter to keep track of the current ray ID
-
-	Scene m_Scene;
-
-	// renderer data
-	float m_WX1, m_WY1, m_WX2, m_WY2;
-	// deltas for interpolation
-	float m_DX, m_DY;
-	float m_SX, m_SY;
-	
-	// data for regular grid stepping
-	Vector3 m_CS; // cell size
-	Vector3 m_RCS; // reverse cell size = 1 / m_CS
-
-	float GetDistance(const Ray& r, RTObject*& nearestO, RTObject* origin=0);
-	float FindNearest(const Ray& a_Ray, RTObject*& nearestObj, RTObject* origin);	
-
-public:	
-
-	void AddObject(RTObject* o);
-	void ImportASE(char *strFileName);
-	void Init();	
-	void Render();
-
-	RTObject* RayTrace(const Ray& ray, Color& color, int depth, float rIndex, RTObject* origin=0);	
-};
-
-#endif // RAYTRACER_H
+/**
+* File : rayTracer.h
+* Description : This is the main class for the raytracer.
+* It implements the raytracing algorithm that fires rays through the pixels
+* in the screen and spawns new rays upon reflection or refraction. The
+* secondary rays are kept in an explicit stack instead of being traced
+* recursively, so the maximum depth can be changed at run time. Secondary
+* rays whose contribution to the pixel falls under a threshold are not traced
+* (or only randomly if the russian roulette is enabled).
+* Several views of the scene (stereo pairs, several cameras) can be rendered
+* in one job sharing the scene and the grid (see RenderViews). After the
+* material of objects has been edited, only the tiles showing them are
+* rendered again (see Invalidate and RenderChanges). Objects can be inserted,
+* removed and moved after Init without building the grid again (see
+* InsertObject). A model can be placed many times while its triangles are
+* stored once (see LoadMesh).
+* Different options can be selected for each render (see SetRenderFlags) :
+* - RENDER_SPATIAL_DIVISION : The spatial division algorithm implemented is described
+* 	in the following paper : "A faster voxel traversal algorithm for ray tracing"
+* 	by John Amanatides and Andrew Woo (can be downloaded from
+* 	http://www.devmaster.net/articles/raytracing_series/part4.php)
+* 	The grid can be replaced by a BVH of the scene, rebuilt after each edit
+* 	and traversed 4 children at a time (see SetAcceleration).
+* - RENDER_ANTI_ALIASING : The anti-aliasing algorithm is based on the super-sampling
+* 	technique : the image is rendered at higher resolutions and an average
+* 	color value is calculated.
+* - RENDER_ADAPTIVE_AA : adaptive super-sampling : the pixels contrasting with
+* 	their neighbors are recursively subdivided as long as the colors of the
+* 	corners of the sub-squares differ (see SetAdaptiveDepth and
+* 	SetContrastThreshold).
+* - RENDER_POST_AA : no additional ray, the edges are smoothed on the final
+* 	image (see EdgeFilter).
+* - RENDER_VERTEX_NORMALS : the normals of the triangles are interpolated
+* 	from the normals of their vertices.
+* - RENDER_PROGRESSIVE : the image is first traced for one pixel out of a
+* 	block of pixels and shown with the color of this pixel for the whole
+* 	block, then refined in passes halving the size of the blocks (see
+* 	SetProgressiveBlock). The pixels traced by a pass are not traced again.
+* - RENDER_REPROJECTION : the primary hits of the last frame are reprojected
+* 	into the new one, their pixels are shaded without searching the nearest
+* 	object nor tracing the shadow rays again (see ReprojectionCache).
+* The options (except RENDER_PROGRESSIVE and RENDER_REPROJECTION) are
+* template parameters of the render and trace methods : each combination is
+* compiled separately, without any test in the loops, and the one matching
+* the flags is called through a table.
+* 
+* Comments : The algorithm used in this class is inspired from :
+* http://www.devmaster.net/articles/raytracing_series/part1.php
+*				  
+* Author(s) : ALucchi
+* Date of creation : 28/10/2007
+* Modification(s) :
+*/
+
+#ifndef RAYTRACER_H
+#define RAYTRACER_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "rtObjects.h"
+#include "scene.h"
+#include "frameBuffer.h"
+#include "edgeFilter.h"
+#include "frameBudget.h"
+#include "camera.h"
+#include "reprojection.h"
+#include "Maths/math3D.h"
+
+//---------------------------------------------------------------------- CONSTS
+
+// default maximum depth of the ray tree (see RayTracer::SetMaxDepth)
+#define MAX_RAYTRACE_DEPTH 3
+// size of the stack of pending rays used by RayTracer::Trace. As every
+// intersection pushes at most two rays, the depth can't exceed this size - 1.
+#define RAY_STACK_SIZE 32
+// default weight under which a secondary ray is not traced anymore
+// (see RayTracer::SetMinWeight). 0 traces every ray up to the maximum depth ;
+// a higher weight cuts the weak rays, which changes the image.
+#define MIN_RAY_WEIGHT 0.0f
+// default and maximum number of subdivisions of a pixel by the adaptive
+// anti-aliasing (see RayTracer::SetAdaptiveDepth)
+#define ADAPTIVE_AA_DEPTH 2
+#define MAX_ADAPTIVE_AA_DEPTH 4
+// default difference between two color components above which the adaptive
+// anti-aliasing subdivides (see RayTracer::SetContrastThreshold)
+#define AA_CONTRAST_THRESHOLD 0.1f
+// default size of the blocks of pixels of the first pass of a progressive
+// render (see RayTracer::SetProgressiveBlock)
+#define PROGRESSIVE_BLOCK 4
+
+//----------------------------------------------------------------------- TYPES
+
+// Options of a render (see RayTracer::SetRenderFlags)
+enum RenderFlags
+{
+	// anti-aliasing mode (one of the values under RENDER_AA_MASK)
+	RENDER_NO_AA = 0,
+	RENDER_ANTI_ALIASING = 1, // super-sampling of the borders of the objects
+	RENDER_ADAPTIVE_AA = 2, // super-sampling driven by the contrast
+	RENDER_POST_AA = 3, // filter applied to the final image
+	RENDER_AA_MASK = 3,
+	RENDER_SPATIAL_DIVISION = 4,
+	RENDER_VERTEX_NORMALS = 8,
+	RENDER_PROGRESSIVE = 16, // not a template parameter
+	RENDER_REPROJECTION = 32, // not a template parameter
+	RENDER_COMBINATIONS = 64 // number of combinations of the flags
+};
+
+// number of anti-aliasing modes
+#define RENDER_AA_MODES 4
+
+#define DEFAULT_RENDER_FLAGS (RENDER_ANTI_ALIASING | RENDER_SPATIAL_DIVISION)
+
+// ----------------------------------------------------------------------------
+// Ray waiting in the stack of pending rays (see RayTracer::RayTrace)
+// ----------------------------------------------------------------------------
+
+struct PendingRay
+{
+	Ray ray;
+	Color weight; // contribution of the color of this ray to the pixel color
+	int depth; // depth of the ray in the ray tree (0 for primary rays)
+	float rIndex; // refraction index of the medium the ray travels through
+	RTObject* origin; // object from which the ray has been traced
+
+	PendingRay():depth(0),rIndex(1.0f),origin(0){}
+	PendingRay(const Ray& r, const Color& w, int d, float n, RTObject* o):
+		ray(r),weight(w),depth(d),rIndex(n),origin(o){}
+};
+
+// ----------------------------------------------------------------------------
+// Number of rays traced during the last frame
+// ----------------------------------------------------------------------------
+
+struct RenderStats
+{
+	int primaryRays; // rays fired from the eye (including super-sampling)
+	int secondaryRays; // reflected and refracted rays
+	int shadowRays; // rays fired towards the lights
+	int culledRays; // secondary rays not traced because of their low weight
+	int reprojected; // pixels shaded from a hit of the last frame
+	int width, height; // resolution of the frame (see RayTracer::GetFrameBudget)
+	int quality; // level chosen by the frame budget (-1 if disabled)
+
+	RenderStats():width(0),height(0),quality(-1) { Reset(); }
+	void Reset() { primaryRays = secondaryRays = shadowRays = culledRays = reprojected = 0; }
+};
+
+// ----------------------------------------------------------------------------
+// Point of view rendered by RayTracer::RenderViews and frame receiving it
+// ----------------------------------------------------------------------------
+
+struct View
+{
+	Camera* camera;
+	FrameBuffer* frame;
+	ReprojectionCache* cache; // last frame of the view (0 to trace every pixel)
+
+	View(Camera* c = 0, FrameBuffer* f = 0, ReprojectionCache* r = 0):
+		camera(c),frame(f),cache(r){}
+};
+
+//----------------------------------------------------------------------- CLASS
+
+// ----------------------------------------------------------------------------
+// RayTracer class
+// ----------------------------------------------------------------------------
+
+class RayTracer
+{
+private:	
+
+	int m_rayID; // counter to keep track of the current ray ID
+	int m_maxDepth; // maximum depth of the ray tree
+	float m_minWeight; // secondary rays contributing less are not traced
+	bool m_russianRoulette; // terminate low weight rays randomly (unbiased)
+	unsigned int m_seed; // state of the random generator used by the roulette
+	int m_renderFlags; // combination of RenderFlags
+	int m_aaDepth; // maximum number of subdivisions of the adaptive anti-aliasing
+	float m_aaThreshold; // contrast above which a pixel is subdivided
+	int m_progressiveBlock; // size of the blocks of the first progressive pass
+
+	RenderStats m_stats;
+
+	Scene m_Scene;
+
+	Camera m_Camera;
+
+	FrameBuffer m_FrameBuffer;
+	const View* m_View; // view of the tile being rendered
+	SampleCache m_SampleCache; // sub-pixel samples of the current tile
+	EdgeFilter m_EdgeFilter; // anti-aliasing of RENDER_POST_AA
+	FrameBudget m_Budget; // quality of the frames when their time is limited
+	ReprojectionCache m_Reprojection; // last frame of the camera of Render
+	unsigned int* m_Touched; // objects touched by the tile being rendered
+	int m_TouchedWords; // number of words of m_Touched
+	const vector<char>* m_Tiles; // tiles rendered by RenderChanges (all if 0)
+	vector<unsigned int> m_Changed; // objects changed since the last frame (one bit each)
+	
+	// data for regular grid stepping
+	Vector3 m_CS; // cell size
+	Vector3 m_RCS; // reverse cell size = 1 / m_CS
+
+	float GetDistance(const Ray& r, RTObject*& nearestO, RTObject* origin=0);
+	float FindNearest(const Ray& a_Ray, RTObject*& nearestObj, RTObject* origin);	
+
+	bool KeepRay(Color& weight);
+	float Random();
+
+	template <int AntiAliasing, bool SpatialDivision, bool VertexNormals>
+	void RenderImage(const View* views, int nbViews);
+	int GetNbJobs(const View* views, int nbViews) const;
+	bool StartJob(const View* views, int nbViews, int job, Tile& tile);
+	template <bool SpatialDivision>
+	Ray GetPrimaryRay(Vector3 dirEye);
+	template <bool SpatialDivision, bool VertexNormals>
+	Color Sample(float x, float y);
+	template <bool SpatialDivision, bool VertexNormals>
+	const Color& GetLatticeSample(int X, int Y);
+	template <bool SpatialDivision, bool VertexNormals>
+	void RenderTile(const Tile& tile, int step, bool refine);
+	void PresentFrame(const FrameBuffer& frame);
+	template <bool SpatialDivision, bool VertexNormals>
+	void AntiAliasTile(const Tile& tile);
+	template <bool SpatialDivision, bool VertexNormals>
+	void AdaptiveTile(const Tile& tile);
+	template <bool SpatialDivision, bool VertexNormals>
+	Color SampleSquare(float x, float y, float h, const Color corners[4],
+		const Color& center, int depth);
+	template <bool SpatialDivision, bool VertexNormals>
+	Color Subdivide(float x, float y, float h, const Color corners[4],
+		const Color edges[4], const Color& center, int depth);
+	template <bool SpatialDivision, bool VertexNormals>
+	RTObject* Trace(const Ray& ray, Color& color);
+	template <bool SpatialDivision, bool VertexNormals>
+	void TracePrimary(const Ray& ray, Color& color, PrimaryHit& hit, bool reuse);
+
+	typedef void (RayTracer::*RenderFunction)(const View* views, int nbViews);
+	typedef RTObject* (RayTracer::*TraceFunction)(const Ray& ray, Color& color);
+	static const RenderFunction s_RenderFunctions[RENDER_AA_MODES]
+		[RENDER_PROGRESSIVE / RENDER_SPATIAL_DIVISION];
+	static const TraceFunction s_TraceFunctions[RENDER_PROGRESSIVE / RENDER_SPATIAL_DIVISION];
+
+public:	
+
+	RayTracer():m_maxDepth(MAX_RAYTRACE_DEPTH),m_minWeight(MIN_RAY_WEIGHT),
+		m_russianRoulette(false),m_seed(1),m_renderFlags(DEFAULT_RENDER_FLAGS),
+		m_aaDepth(ADAPTIVE_AA_DEPTH),m_aaThreshold(AA_CONTRAST_THRESHOLD),
+		m_progressiveBlock(PROGRESSIVE_BLOCK),
+		m_FrameBuffer(SCR_WIDTH, SCR_HEIGHT),m_View(0),m_Touched(0),m_TouchedWords(0),m_Tiles(0){}
+
+	void AddObject(RTObject* o);
+	void InsertObject(RTObject* o);
+	void RemoveObject(RTObject* o);
+	void MoveObject(RTObject* o, const Vector3& offset);
+	void UpdateObject(RTObject* o);
+	void ImportASE(char *strFileName);
+	Mesh* LoadMesh(const char* strFileName, BVHSplit split = BVH_SPLIT_SAH);
+	void Init();	
+	void Render();
+	void RenderViews(const View* views, int nbViews);
+	void Invalidate(RTObject* object);
+	int RenderChanges();
+
+	int GetMaxDepth() const {return m_maxDepth;}
+	void SetMaxDepth(int depth);
+	float GetMinWeight() const {return m_minWeight;}
+	void SetMinWeight(float weight) {m_minWeight = weight;}
+	bool GetRussianRoulette() const {return m_russianRoulette;}
+	void SetRussianRoulette(bool enable) {m_russianRoulette = enable;}
+	int GetRenderFlags() const {return m_renderFlags;}
+	void SetRenderFlags(int flags);
+	int GetAdaptiveDepth() const {return m_aaDepth;}
+	void SetAdaptiveDepth(int depth);
+	float GetContrastThreshold() const {return m_aaThreshold;}
+	SceneAcceleration GetAcceleration() const {return m_Scene.GetAcceleration();}
+	void SetAcceleration(SceneAcceleration accel, BVHSplit split = BVH_SPLIT_MORTON,
+		bool quantized = false) {m_Scene.SetAcceleration(accel, split, quantized);}
+	const BVH& GetSceneBVH() const {return m_Scene.GetBVH();}
+	const WideBVH& GetSceneWideBVH() const {return m_Scene.GetWideBVH();}
+	void SetContrastThreshold(float threshold) {m_aaThreshold = threshold;}
+	int GetProgressiveBlock() const {return m_progressiveBlock;}
+	void SetProgressiveBlock(int size);
+
+	const RenderStats& GetStats() const {return m_stats;}
+	const FrameBuffer& GetFrameBuffer() const {return m_FrameBuffer;}
+	EdgeFilter& GetEdgeFilter() {return m_EdgeFilter;}
+	FrameBudget& GetFrameBudget() {return m_Budget;}
+	Camera& GetCamera() {return m_Camera;}
+	ReprojectionCache& GetReprojectionCache() {return m_Reprojection;}
+
+	RTObject* RayTrace(const Ray& ray, Color& color);	
+};
+
+#endif // RAYTRACER_H
@@ -0,0 +1,121 @@
+/**
+* File : reprojection.cpp
+* Description : Cache of the primary hits of the last frame of a view.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "reprojection.h"
+
+#include <limits>
+
+//--------------------------------------------------------------------- METHODS
+
+/**
+ * Forgets the last frame : every pixel of the next frame is traced.
+ */
+void ReprojectionCache::Clear()
+{
+	m_Hits.clear();
+}
+
+/**
+ * Keeps the hits of a frame (except the pixels showing the background).
+ */
+void ReprojectionCache::Store(const FrameBuffer& frame)
+{
+	m_Hits.clear();
+	if(m_MaxAge <= 0)
+		return;
+
+	for(int y = 0; y < frame.GetHeight(); y++)
+	{
+		for(int x = 0; x < frame.GetWidth(); x++)
+		{
+			const PrimaryHit& hit = frame.GetHit(x, y);
+			if(hit.object)
+				m_Hits.push_back(hit);
+		}
+	}
+}
+
+/**
+ * Finds the candidates of the pixels of the next frame : each hit of the last
+ * frame is given to the pixel it falls into, unless a hit nearer to the
+ * camera falls into the same pixel. The pixels on the borders of the objects
+ * and of the shadows get no candidate, nor the pixels whose candidate has been
+ * reused for too many frames. This number of frames depends on the pixel
+ * (between 1 and the maximum age), so that the pixels traced in the same frame
+ * don't all expire together.
+ * @param width, height resolution of the next frame.
+ */
+void ReprojectionCache::Reproject(const Camera& camera, int width, int height)
+{
+	m_Width = width;
+	m_Candidates.assign(width * height, -1);
+	m_Depths.assign(width * height, std::numeric_limits<float>::infinity());
+
+	const Vector3& eye = camera.GetPosition();
+	for(size_t i = 0; i < m_Hits.size(); i++)
+	{
+		float x, y;
+		if(!camera.Project(m_Hits[i].position, x, y))
+			continue;
+		// nearest pixel (the centers of the pixels have integer coordinates)
+		x += 0.5f;
+		y += 0.5f;
+		if(x < 0 || x >= width || y < 0 || y >= height)
+			continue;
+
+		int pixel = (int)x + (int)y * width;
+		Vector3 d = m_Hits[i].position - eye;
+		float depth = Dot(d, d);
+		if(depth < m_Depths[pixel])
+		{
+			m_Depths[pixel] = depth;
+			m_Candidates[pixel] = (int)i;
+		}
+	}
+	// the visibility of the objects and of the lights changes on their
+	// borders : the pixels whose neighbors don't see the same object with the
+	// same lights are traced
+	m_Borders.assign(width * height, 0);
+	for(int y = 0; y < height; y++)
+	{
+		for(int x = 0; x < width; x++)
+		{
+			int pixel = x + y * width;
+			if(m_Candidates[pixel] < 0)
+				continue;
+			if((x > 0 && !IsSame(pixel, pixel - 1)) ||
+				(x < width - 1 && !IsSame(pixel, pixel + 1)) ||
+				(y > 0 && !IsSame(pixel, pixel - width)) ||
+				(y < height - 1 && !IsSame(pixel, pixel + width)))
+				m_Borders[pixel] = 1;
+		}
+	}
+	for(int y = 0; y < height; y++)
+	{
+		for(int x = 0; x < width; x++)
+		{
+			int pixel = x + y * width;
+			int i = m_Candidates[pixel];
+			if(i >= 0 && (m_Borders[pixel] || m_Hits[i].age >= m_MaxAge - (x + 3 * y) % m_MaxAge))
+				m_Candidates[pixel] = -1;
+		}
+	}
+}
+
+/**
+ * @return true if the candidates of two pixels see the same object with the
+ * same lights.
+ */
+bool ReprojectionCache::IsSame(int pixel1, int pixel2) const
+{
+	int i = m_Candidates[pixel1], j = m_Candidates[pixel2];
+	return j >= 0 && m_Hits[i].object == m_Hits[j].object &&
+		m_Hits[i].lights == m_Hits[j].lights;
+}
@@ -0,0 +1,84 @@
+/**
+* File : reprojection.h
+* Description : Cache of the primary hits of the last frame of a view,
+* reprojected into the next frame so that small moves of the camera don't
+* require tracing every pixel again. After a frame, Store keeps the hits of
+* its pixels (see PrimaryHit). Before the next frame, Reproject projects the
+* hit points into the new camera : each pixel receives the nearest point
+* falling into it as a candidate. The ray tracer then only intersects the
+* primary ray of the pixel with the object of the candidate and reuses the
+* visibility of the lights stored with it instead of tracing the shadow rays.
+* The pixels without candidate (disoccluded, entering the frame or showing
+* the background), those on the borders of the objects and of the shadows and
+* those whose ray misses the object of their candidate are traced normally.
+* The reflected and refracted rays depend on the point of view : they are
+* always traced.
+* The candidates are not tested against the other objects : an object coming
+* in front of reprojected points without any border in the last frame is only
+* seen once the points expire (see SetMaxAge). The cache must be cleared when
+* the scene changes.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef REPROJECTION_H
+#define REPROJECTION_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "frameBuffer.h"
+#include "camera.h"
+
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------- CONSTS
+
+// default maximum number of frames a hit can be reused before its shadow
+// rays are traced again (see ReprojectionCache::SetMaxAge)
+#define REPROJECTION_MAX_AGE 16
+
+//----------------------------------------------------------------------- CLASS
+
+// ----------------------------------------------------------------------------
+// ReprojectionCache class
+// ----------------------------------------------------------------------------
+
+class ReprojectionCache
+{
+public:
+	ReprojectionCache():m_MaxAge(REPROJECTION_MAX_AGE),m_Width(0){}
+
+	/**
+	 * Maximum number of frames a hit is reused (0 disables the cache).
+	 */
+	int GetMaxAge() const { return m_MaxAge; }
+	void SetMaxAge(int age) { m_MaxAge = age; }
+
+	void Clear();
+	void Store(const FrameBuffer& frame);
+	void Reproject(const Camera& camera, int width, int height);
+
+	/**
+	 * @return the candidate of the pixel (x, y) of the next frame or 0 if
+	 * it has none.
+	 */
+	const PrimaryHit* GetCandidate(int x, int y) const
+	{
+		int i = m_Candidates[x + y * m_Width];
+		return (i >= 0) ? &m_Hits[i] : 0;
+	}
+
+private:
+	bool IsSame(int pixel1, int pixel2) const;
+
+	int m_MaxAge;
+	vector<PrimaryHit> m_Hits; // hits of the last frame
+	int m_Width; // width of the next frame
+	vector<int> m_Candidates; // index in m_Hits for each pixel (-1 if none)
+	vector<float> m_Depths; // square distance of the candidates to the camera
+	vector<char> m_Borders; // pixels on the border of an object or a shadow
+};
+
+#endif // REPROJECTION_H
@@ -11,10 +11,20 @@
 #include "rtObjects.h"
 #include "defs.h"
 #include "rayBoxInt.inl"
+#include "primitives.h"
 #include <algorithm>
 
 //--------------------------------------------------------------------- METHODS
 
+/**
+ * @return an infinite box : the object may intersect any cell of the grid.
+ */
+Box RTObject::GetBounds() const
+{
+	const float inf = std::numeric_limits<float>::infinity();
+	return Box(Vector3(-inf, -inf, -inf), Vector3(inf, inf, inf));
+}
+
 /**
  * Finds the nearest intersection between a plane and the specified ray.
  * @param ray the ray that will be fired into the scene.
@@ -25,17 +35,7 @@
 float Plane::Intersect(const Ray& a_Ray)
 {
 	m_rayID = a_Ray.GetID();
-	
-	float d = Dot( m_N, a_Ray.GetDirection() );
-	if (d != 0)
-	{
-		// Non orthogonal
-		float dist = -(Dot( m_N, a_Ray.GetOrigin() ) + m_d) / d;
-		if(dist > 0)
-			return dist;
-		//return fabs((Dot( m_N, a_Ray.GetOrigin() ) + m_d) / d);
-	}
-	return std::numeric_limits<float>::infinity();
+	return IntersectPlane(m_N, m_d, a_Ray);
 }
 
 /**
@@ -75,37 +75,7 @@ bool Plane::IntersectBoundingBox(const Vector3& v1, const Vector3& v2)
 float Sphere::Intersect(const Ray &a_Ray)
 {
 	m_rayID = a_Ray.GetID();
-	
-	Vector3 dst = a_Ray.GetOrigin() - m_pos;
-	Vector3 dirRay = a_Ray.GetDirection();
-
-	float a_Dist = std::numeric_limits<float>::infinity();
-	float b = -Dot( dst, dirRay );
-	float det = (b * b) - Dot( dst, dst ) + m_radius;
-	if (det > 0)
-	{
-		det = sqrtf( det );
-		float i1 = b - det;
-		float i2 = b + det;
-		if (i2 > 0)
-		{
-			if (i1 < 0) 
-			{
-				if (i2 < a_Dist) 
-				{
-					a_Dist = i2;
-				}
-			}
-			else
-			{
-				if (i1 < a_Dist)
-				{
-					a_Dist = i1;
-				}
-			}
-		}
-	}
-	return a_Dist;
+	return IntersectSphere(m_pos, m_radius, a_Ray);
 }
 
 /**
@@ -151,6 +121,17 @@ bool Sphere::IntersectBoundingBox(const Vector3& v1, const Vector3& v2)
 	return (dmin <= (m_radius*m_radius));
 }
 
+/**
+ * The intersection uses m_radius as the square radius (see IntersectSphere),
+ * the bounds cover the largest of both spheres.
+ */
+Box Sphere::GetBounds() const
+{
+	float radius = std::max(m_radius, sqrtf(m_radius));
+	Vector3 r(radius, radius, radius);
+	return Box(m_pos - r, m_pos + r);
+}
+
 /**
  * Finds the nearest intersection between a triangle and the specified ray.
  * Implementation based on :
@@ -164,58 +145,9 @@ float Triangle::Intersect(const Ray& a_Ray)
 {
 	m_rayID = a_Ray.GetID();
 	
-	Vector3 D = a_Ray.GetDirection();	
-	float d = Dot(D, m_N);
-	
-	if (d != 0)
-	{
-		Vector3 O = a_Ray.GetOrigin();
-		float dist = -(Dot(m_N, O-m_A)) / d;
-		if(dist > 0)
-		{
-			Vector3 bt = m_B - m_A;
-			Vector3 ct = m_C - m_A;	
-			Vector3 P = O + dist * D;
-			Vector3 pt = P - m_A;
-			
-			Vector2 b;
-			Vector2 c;	
-			Vector2 p;
-			
-			if(bt.x == 0 && ct.x == 0)
-			{
-				b.Set(bt.y, bt.z);
-				c.Set(ct.y, ct.z);
-				p.Set(pt.y, pt.z);
-			}
-			else if(bt.y == 0 && ct.y == 0)
-			{
-				b.Set(bt.x, bt.z);
-				c.Set(ct.x, ct.z);
-				p.Set(pt.x, pt.z);
-			}
-			else
-			{
-				b.Set(bt.x, bt.y);
-				c.Set(ct.x, ct.y);
-				p.Set(pt.x, pt.y);
-			}	
-			
-			float dU = b.y*c.x - b.x*c.y;
-			float u = p.y*c.x - p.x*c.y;
-			if(dU != 0)
-				u /= dU;
-				
-			float dV = c.y*b.x - c.x*b.y;
-			float v = p.y*b.x - p.x*b.y;
-			if(dV != 0)
-				v /= dV;				
-				
-			if(u>=0 && v>=0 && (u+v)<=1)
-				return dist;
-		}
-	}
-	return std::numeric_limits<float>::infinity();
+	TriangleData t;
+	SetTriangleData(t, m_A, m_B, m_C);
+	return IntersectTriangle(t, a_Ray);
 }
 
 /**
@@ -235,96 +167,67 @@ bool Triangle::IntersectBoundingBox(const Vector3& v1, const Vector3& v2)
 	return (triBoxOverlap(boxcenter,boxhalfsize,triverts)==1);
 }
 
+Box Triangle::GetBounds() const
+{
+	Box box;
+	box.Extend(m_A);
+	box.Extend(m_B);
+	box.Extend(m_C);
+	return box;
+}
+
 Vector3 Triangle::GetNormal(Vector3& pos)
 {
-#ifdef VERTEX_NORMAL
-	float dA = (m_A - pos).LengthSq();
-	float dB = (m_B - pos).LengthSq();
-	float dC = (m_C - pos).LengthSq();
-	
-	if(dA < dB)
-	{
-		if(dA < dC)
-			return dA;
-		else
-			return dC;
-	}
-	else
-	{
-		if(dB < dC)
-			return dB;
-		else
-			return dC;		
-	}
-	
-#else	
 	return m_N;
-#endif // VERTEX_NORMAL
 }
 
-#ifdef VERTEX_NORMAL
+/**
+ * @return the normal at the point pos of the triangle, interpolated from the
+ * normals of the vertices with the barycentric coordinates of pos. The normal
+ * is turned to the same side as the normal of the triangle.
+ */
+Vector3 Triangle::GetVertexNormal(const Vector3& pos) const
+{
+	Vector3 AB = m_B - m_A;
+	Vector3 AC = m_C - m_A;
+	Vector3 AP = pos - m_A;
+	float d00 = Dot(AB, AB);
+	float d01 = Dot(AB, AC);
+	float d11 = Dot(AC, AC);
+	float d20 = Dot(AP, AB);
+	float d21 = Dot(AP, AC);
+	float denom = d00 * d11 - d01 * d01;
+	if(denom == 0)
+		return m_N;
+
+	float v = (d11 * d20 - d01 * d21) / denom;
+	float w = (d00 * d21 - d01 * d20) / denom;
+	Vector3 N = m_NA * (1.0f - v - w) + m_NB * v + m_NC * w;
+	if(Dot(N, m_N) < 0)
+		N = -N;
+	return N;
+}
+
 void Triangle::SetVertexNormals(Vector3 N[3])
 {
 	m_NA = N[0];
 	m_NB = N[1];
 	m_NC = N[2];
 }
-#endif // VERTEX_NORMAL
 
 /**
  * Finds the nearest intersection between a box and the specified ray.
- * Implementation based on Smits’ method
- * @TODO : see improved code on http://cag.csail.mit.edu/~amy/papers/box-jgt.pdf
  * @param ray the ray that will be fired into the scene.
  * @return std::numeric_limits<float>::infinity() if no intersection detected.
- * Otherwise the distance between the intersected object and the origin of the
- * ray is returned.
+ * Otherwise the distance between the point where the ray enters the box and
+ * the origin of the ray is returned (0 if the origin is inside the box).
  */
 float Box::Intersect(const Ray &ray) const
 {
-	float a_Dist;
-	float dist[6];
-	Vector3 ip[6], d = ray.GetDirection(), o = ray.GetOrigin();
-
-	int i;
-	for (i = 0; i < 6; i++) dist[i] = -1;
-
-	if (d.x) 
-	{
-		float rc = 1.0f / d.x;
-		dist[0] = (m_bounds[0].x - o.x) * rc;
-		dist[3] = (m_bounds[1].x - o.x) * rc;
-	}
-	if (d.y) 
-	{
-		float rc = 1.0f / d.y;
-		dist[1] = (m_bounds[0].y - o.y) * rc;
-		dist[4] = (m_bounds[1].y - o.y) * rc;
-	}
-	if (d.z) 
-	{
-		float rc = 1.0f / d.z;
-		dist[2] = (m_bounds[0].z - o.z) * rc;
-		dist[5] = (m_bounds[1].z - o.z) * rc;
-	}
-	
-	for ( i = 0; i < 6; i++ )
-		if (dist[i] > 0)
-		{
-			// Check if the intersection point is inside the box
-			ip[i] = o + dist[i] * d;
-			if ((ip[i].x > (m_bounds[0].x - EPSILON)) && (ip[i].x < (m_bounds[1].x + EPSILON)) && 
-				(ip[i].y > (m_bounds[0].y - EPSILON)) && (ip[i].y < (m_bounds[1].y + EPSILON)) &&
-				(ip[i].z > (m_bounds[0].z - EPSILON)) && (ip[i].z < (m_bounds[1].z + EPSILON)))
-			{
-				if (dist[i] < a_Dist) 
-				{
-					a_Dist = dist[i];
-				}
-			}
-		}
-		
-	return a_Dist;
+	float tnear, tfar;
+	if(Intersect(ray, 0, std::numeric_limits<float>::infinity(), tnear, tfar))
+		return tnear;
+	return std::numeric_limits<float>::infinity();
 }
 
 /**
@@ -336,3 +239,14 @@ bool Box::Contains(Vector3& v)
 			(v.y > (m_bounds[0].y - EPSILON)) && (v.y < (m_bounds[1].y + EPSILON)) &&
 			(v.z > (m_bounds[0].z - EPSILON)) && (v.z < (m_bounds[1].z + EPSILON)));
 }
+
+/**
+ * @return true if the box overlaps the box whose lower left corner is v1 and
+ * upper right corner is v2.
+ */
+bool Box::Overlaps(const Vector3& v1, const Vector3& v2) const
+{
+	return ((m_bounds[0].x <= v2.x) && (m_bounds[1].x >= v1.x) &&
+			(m_bounds[0].y <= v2.y) && (m_bounds[1].y >= v1.y) &&
+			(m_bounds[0].z <= v2.z) && (m_bounds[1].z >= v1.z));
+}
@@ -32,13 +32,27 @@ private:
 	int m_Id;
 	Vector3 m_dir; // direction
 	Vector3 m_pos; // center of the object
+	// data precomputed for the ray/box intersection
+	Vector3 m_invDir; // 1 / direction
+	int m_sign[3]; // 1 if the direction is negative along the axis
+
+	void Precompute()
+	{
+		m_invDir = 1.0f / m_dir;
+		m_sign[0] = (m_invDir.x < 0);
+		m_sign[1] = (m_invDir.y < 0);
+		m_sign[2] = (m_invDir.z < 0);
+	}
 
 public:
 	Vector3 GetDirection() const {return m_dir;}	
 	Vector3 GetOrigin() const {return m_pos;}
+	const Vector3& GetInvDirection() const {return m_invDir;}
+	int GetSign(int axis) const {return m_sign[axis];}
 	int GetID() const {return m_Id;}
 	void SetOrigin(Vector3& pos) {m_pos=pos;}
-	Ray(Vector3& p, Vector3& d, int rID):m_pos(p),m_dir(d),m_Id(rID){}
+	Ray():m_Id(0){ m_sign[0] = m_sign[1] = m_sign[2] = 0; }
+	Ray(Vector3& p, Vector3& d, int rID):m_pos(p),m_dir(d),m_Id(rID){ Precompute(); }
 };
 
 // -----------------------------------------------------------
@@ -46,6 +60,12 @@ public:
 // -----------------------------------------------------------
 class Box {
 public:
+	// empty box (see Extend)
+	Box() {
+		const float inf = std::numeric_limits<float>::infinity();
+		m_bounds[0] = Vector3(inf, inf, inf);
+		m_bounds[1] = Vector3(-inf, -inf, -inf);
+	}
 	Box(const Vector3 &min, const Vector3 &max) {
 		assert(min < max);
 		m_bounds[0] = min;
@@ -53,14 +73,74 @@ public:
 	}
 	bool Contains(Vector3& v);
 	float Intersect(const Ray &r) const;
+	bool Intersect(const Ray &r, float t0, float t1, float& tnear, float& tfar) const;
+	bool Overlaps(const Vector3& v1, const Vector3& v2) const;
+	void Extend(const Vector3& v);
+	void Extend(const Box& b) { Extend(b.m_bounds[0]); Extend(b.m_bounds[1]); }
 	
 	Vector3 GetMin() const {return m_bounds[0];}
 	Vector3 GetMax() const {return m_bounds[1];}
 	Vector3 GetSize() const {return m_bounds[1]-m_bounds[0];}
+	Vector3 GetCenter() const {return (m_bounds[0]+m_bounds[1])*0.5f;}
+	float GetArea() const;
 private:	
 	Vector3 m_bounds[2];
 };
 
+/**
+ * Slab test between a box and the specified ray, based on :
+ * "An Efficient and Robust Ray-Box Intersection Algorithm" by Amy Williams,
+ * Steve Barrus, R. Keith Morley and Peter Shirley.
+ * The near and far planes of each slab are selected with the sign of the
+ * direction precomputed by the ray, and the intervals are merged with min/max
+ * instead of branches. An infinite inverse direction (ray parallel to a slab)
+ * is handled by the IEEE rules ; the NaN produced when the origin lies exactly
+ * on such a slab is ignored : it is always the first argument of MaxF/MinF,
+ * the second one (starting from t0 and t1) being returned.
+ * @param t0, t1 interval of the ray to be tested.
+ * @param tnear, tfar distances at which the ray enters and leaves the box.
+ * @return true if the ray hits the box inside [t0, t1].
+ */
+inline bool Box::Intersect(const Ray &r, float t0, float t1, float& tnear, float& tfar) const
+{
+	const Vector3& o = r.GetOrigin();
+	const Vector3& inv = r.GetInvDirection();
+	float txmin = (m_bounds[r.GetSign(0)].x - o.x) * inv.x;
+	float txmax = (m_bounds[1 - r.GetSign(0)].x - o.x) * inv.x;
+	float tymin = (m_bounds[r.GetSign(1)].y - o.y) * inv.y;
+	float tymax = (m_bounds[1 - r.GetSign(1)].y - o.y) * inv.y;
+	float tzmin = (m_bounds[r.GetSign(2)].z - o.z) * inv.z;
+	float tzmax = (m_bounds[1 - r.GetSign(2)].z - o.z) * inv.z;
+	tnear = MaxF(txmin, MaxF(tymin, MaxF(tzmin, t0)));
+	tfar = MinF(txmax, MinF(tymax, MinF(tzmax, t1)));
+	return tnear <= tfar;
+}
+
+/**
+ * Grows the box so that it contains the point v. Inlined with GetArea : the
+ * builds of the BVHs call them for every primitive and every bin of the nodes.
+ */
+inline void Box::Extend(const Vector3& v)
+{
+	m_bounds[0].x = std::min(m_bounds[0].x, v.x);
+	m_bounds[0].y = std::min(m_bounds[0].y, v.y);
+	m_bounds[0].z = std::min(m_bounds[0].z, v.z);
+	m_bounds[1].x = std::max(m_bounds[1].x, v.x);
+	m_bounds[1].y = std::max(m_bounds[1].y, v.y);
+	m_bounds[1].z = std::max(m_bounds[1].z, v.z);
+}
+
+/**
+ * @return the surface area of the box (0 for an empty box).
+ */
+inline float Box::GetArea() const
+{
+	Vector3 d = m_bounds[1] - m_bounds[0];
+	if(d.x < 0 || d.y < 0 || d.z < 0)
+		return 0;
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
 // -----------------------------------------------------------
 // Material class
 // -----------------------------------------------------------
@@ -98,6 +178,7 @@ protected:
 	Vector3 m_pos; // center of the object
 	RTMaterial m_material;
 	int m_rayID; // ID of the last ray that was tested for intersection
+	int m_index; // index of the object in the scene (see Scene::BuildPrimitives)
 
 public:
 	enum TYPE
@@ -105,19 +186,28 @@ public:
 		SPHERE = 1,
 		LIGHT,
 		PLANE,
-		TRIANGLE
+		TRIANGLE,
+		SPHERE_CLOUD,
+		MESH_INSTANCE
 	};
 	
-	RTObject(Vector3& p, int t=0):m_pos(p),m_type(t),m_rayID(-1){}
+	RTObject(Vector3& p, int t=0):m_pos(p),m_type(t),m_rayID(-1),m_index(-1){}
+	virtual ~RTObject() {}
 
 	virtual RTMaterial* GetMaterial() { return &m_material;}
 	virtual Vector3 GetNormal( Vector3& pos ) {return Vector3(0,0,0);}
 	virtual Vector3 GetPosition() { return m_pos; }
 	virtual int GetType() { return m_type; }
 	virtual int GetRayID() { return m_rayID; }
+	int GetIndex() const { return m_index; }
+	void SetIndex(int index) { m_index = index; }
 	virtual float Intersect(const Ray &ray) { return std::numeric_limits<float>::infinity();}
 	virtual bool IntersectBoundingBox(const Vector3& v1, const Vector3& v2) {return false;}
 	bool IntersectBoundingBox(const Box& box) {return IntersectBoundingBox(box.GetMin(),box.GetMax());}	
+	// box containing the object (infinite for an unbounded object)
+	virtual Box GetBounds() const;
+	// moves the object (see Scene::UpdateObject)
+	virtual void Translate(const Vector3& offset) { m_pos += offset; }
 };
 
 class Plane : public RTObject
@@ -129,6 +219,7 @@ public:
 	Vector3 GetNormal(Vector3& pos) {return m_N;}
 	float Intersect(const Ray &ray);
 	bool IntersectBoundingBox(const Vector3& v1, const Vector3& v2);	
+	void Translate(const Vector3& offset) { m_d -= Dot(m_N, offset); }
 	Plane(Vector3 N, float d):RTObject(NULLVECTOR3,PLANE),m_N(N),m_d(d){}
 };
 
@@ -150,6 +241,7 @@ public:
 	Vector3 GetNormal(Vector3& pos) { return (pos - m_pos) * m_radius; }
 	float Intersect(const Ray &a_Ray);
 	bool IntersectBoundingBox(const Vector3& v1, const Vector3& v2);
+	Box GetBounds() const;
 };
 
 class Light : public Sphere
@@ -163,23 +255,23 @@ class Triangle : public RTObject
 private:
 	Vector3 m_A, m_B, m_C; // coordinates
 	Vector3 m_N; // triangle normal
-
-#ifdef VERTEX_NORMAL
 	Vector3 m_NA, m_NB, m_NC; // vertex normals
-#endif
 
 public:
 	Vector3 GetNormal(Vector3& pos);
+	Vector3 GetVertexNormal(const Vector3& pos) const;
+	Vector3 GetVertex(int i) { return (i == 0) ? m_A : ((i == 1) ? m_B : m_C); }
 	float Intersect(const Ray &ray);
 	bool IntersectBoundingBox(const Vector3& v1, const Vector3& v2);
-#ifdef VERTEX_NORMAL
+	Box GetBounds() const;
+	void Translate(const Vector3& offset) { m_A += offset; m_B += offset; m_C += offset; }
 	void SetVertexNormals(Vector3 N[3]);
-#endif	
 	
 	Triangle(Vector3 A, Vector3 B, Vector3 C):
 		RTObject(NULLVECTOR3,TRIANGLE),m_A(A),m_B(B),m_C(C)
 		{
 			m_N = Cross((m_B-m_A),(m_C-m_A)); // AB.AC => clockwize
+			m_NA = m_NB = m_NC = m_N;
 		}
 };
 
@@ -11,8 +11,62 @@
 #include "defs.h"
 #include "scene.h"
 
-Scene::Scene()
-{	
+#include <algorithm>
+
+//--------------------------------------------------------------------- HELPERS
+
+/**
+ * Remove a primitive from its array by moving the last one in its place.
+ * @return the object of the primitive moved, 0 if the last one was removed.
+ */
+template <class T>
+static RTObject* RemoveFromArray(vector<T>& prims, int i)
+{
+	RTObject* moved = 0;
+	if(i + 1 < (int)prims.size())
+	{
+		prims[i] = prims.back();
+		moved = prims[i].object;
+	}
+	prims.pop_back();
+	return moved;
+}
+
+/**
+ * Add the references and the bounds of the primitives of an array to the
+ * input of the BVH of the scene.
+ */
+template <class T>
+static void AddToBVH(const vector<T>& prims, int type, vector<PrimRef>& refs,
+	vector<Box>& bounds)
+{
+	for(int i = 0; i < (int)prims.size(); i++)
+	{
+		PrimRef ref = {type, i};
+		refs.push_back(ref);
+		bounds.push_back(prims[i].object->GetBounds());
+	}
+}
+
+/**
+ * @return the cell containing a coordinate expressed in cells from the start
+ * of the grid, clamped to the grid.
+ */
+static int GetCell(float f)
+{
+	if(!(f > 0))
+		return 0;
+	if(f >= GRIDSIZE - 1)
+		return GRIDSIZE - 1;
+	return (int)f;
+}
+
+//--------------------------------------------------------------------- METHODS
+
+Scene::Scene():m_Grid(0),m_DistancesDirty(false),m_Acceleration(ACCEL_GRID),
+	m_QuantizedBVH(false),m_BvhDirty(false),m_Clipper(*this),m_box(0)
+{
+	m_Bvh.SetClipper(&m_Clipper);
 }
 
 Scene::~Scene()
@@ -20,14 +74,43 @@ Scene::~Scene()
 	if(m_box)
 		delete m_box;
 
-	// TODO : Delete all the elements...
 	if(m_Grid)
 		delete[] m_Grid;
+
+	map<string, Mesh*>::iterator iMeshes;
+	for(iMeshes = m_Meshes.begin(); iMeshes != m_Meshes.end(); iMeshes++)
+		delete iMeshes->second;
+}
+
+/**
+ * Copy the objects of the scene into the arrays of primitives (one array per
+ * type of primitive) used by the intersection loops and number the objects in
+ * the order of the list (see RTObject::GetIndex). This method must be
+ * called again if objects are added to the scene with AddObject.
+ */
+void Scene::BuildPrimitives()
+{
+	m_Spheres.clear();
+	m_Planes.clear();
+	m_Triangles.clear();
+	m_Clouds.clear();
+	m_Instances.clear();
+	m_Lights.clear();
+	m_Entries.clear();
+	
+	list<RTObject*>::iterator iObjects;
+	for( iObjects = lObjects.begin(); iObjects != lObjects.end(); iObjects++ )
+	{
+		RTObject* o = *iObjects;
+		o->SetIndex((int)m_Entries.size());
+		m_Entries.push_back(ObjectEntry());
+		AddPrimitive(o);
+	}
 }
 
 /**
- * Build the 3d grid which contains cells referencing the objects that
- * intersect with each cell.
+ * Build the 3d grid which contains cells referencing the primitives that
+ * intersect with each cell. BuildPrimitives must have been called first.
  * @TODO : see optimization on http://www.devmaster.net/articles/raytracing_series/part4.php
  */
 void Scene::BuildGrid()
@@ -36,59 +119,412 @@ void Scene::BuildGrid()
 	#define C 100
 	const Vector3 start(-C,-C,-C);
 	const Vector3 end(C,C,C);
+	delete m_box;
 	m_box=new Box(start,end);
 	// TODO : change / operator for Vector3
-	Vector3 size = (end - start) * (1.0f / GRIDSIZE);	
+	m_CellSize = (end - start) * (1.0f / GRIDSIZE);
+	
+	int nbCells = GRIDSIZE*GRIDSIZE*GRIDSIZE;
+	delete[] m_Grid;
+	m_Grid=new GridCell[nbCells];
 	
-	int nbObjects = GRIDSIZE*GRIDSIZE*GRIDSIZE;
-	m_Grid=new ObjectList*[nbObjects];
+	// the primitives are added in the order of their arrays, so the
+	// references of each cell are sorted
+	for(int i = 0; i < (int)m_Spheres.size(); i++)
+		AddToGrid(m_Spheres[i].object);
+	for(int i = 0; i < (int)m_Planes.size(); i++)
+		AddToGrid(m_Planes[i].object);
+	for(int i = 0; i < (int)m_Triangles.size(); i++)
+		AddToGrid(m_Triangles[i].object);
+	for(int i = 0; i < (int)m_Clouds.size(); i++)
+		AddToGrid(m_Clouds[i].object);
+	for(int i = 0; i < (int)m_Instances.size(); i++)
+		AddToGrid(m_Instances[i].object);
+	BuildDistances();
 	
-	// delta values
-	float dx = (end.x - start.x) / GRIDSIZE;
-	float dy = (end.y - start.y) / GRIDSIZE;
-	float dz = (end.z - start.z) / GRIDSIZE;	
-		
-	for (int gZ = 0; gZ < GRIDSIZE; gZ++)	
-		for (int gY = 0; gY < GRIDSIZE; gY++)
-			for (int gX = 0; gX < GRIDSIZE; gX++)
+	#ifdef DEBUG
+		for (int i = 0; i < nbCells; i++)
+		{
+			GridCell& cell = m_Grid[i];
+			cout << "Cell " << i % GRIDSIZE << " " << (i / GRIDSIZE) % GRIDSIZE << " " << i / (GRIDSIZE * GRIDSIZE) << " : ";
+			cout << cell.m_Prims[PRIM_SPHERE].size() << " spheres, ";
+			cout << cell.m_Prims[PRIM_PLANE].size() << " planes, ";
+			cout << cell.m_Prims[PRIM_TRIANGLE].size() << " triangles, ";
+			cout << cell.m_Prims[PRIM_CLOUD].size() << " sphere clouds, ";
+			cout << cell.m_Prims[PRIM_INSTANCE].size() << " mesh instances, ";
+			cout << "distance " << cell.m_Distance << "\n";
+		}
+	#endif
+}
+
+/**
+ * Build the BVH over the bounded primitives, used instead of the grid when
+ * the acceleration is ACCEL_BVH, and collapse it into a 4-wide BVH.
+ * BuildPrimitives must have been called first.
+ */
+void Scene::BuildBVH()
+{
+	m_BvhPrims.clear();
+	vector<Box> bounds;
+	AddToBVH(m_Spheres, PRIM_SPHERE, m_BvhPrims, bounds);
+	AddToBVH(m_Triangles, PRIM_TRIANGLE, m_BvhPrims, bounds);
+	AddToBVH(m_Clouds, PRIM_CLOUD, m_BvhPrims, bounds);
+	AddToBVH(m_Instances, PRIM_INSTANCE, m_BvhPrims, bounds);
+	m_Bvh.Build(bounds, SCENE_LEAF_SIZE);
+	m_WideBvh.Build(m_Bvh, m_QuantizedBVH);
+	m_BvhDirty = false;
+}
+
+/**
+ * Selects the structure traversed by the rays. The BVH is built right away if
+ * the primitives are already built.
+ * @param split method used to build the BVH (see BVH::SetSplitMethod). The
+ * Morton codes give the fastest rebuilds after the edits.
+ * @param quantized stores the bounds of the wide BVH on 8 bits (see WideBVH).
+ */
+void Scene::SetAcceleration(SceneAcceleration accel, BVHSplit split, bool quantized)
+{
+	m_Acceleration = accel;
+	m_Bvh.SetSplitMethod(split);
+	m_QuantizedBVH = quantized;
+	if(accel == ACCEL_BVH && m_Grid)
+		BuildBVH();
+	else if(accel != ACCEL_BVH)
+	{
+		m_Bvh.Clear();
+		m_WideBvh.Clear();
+		m_BvhPrims.clear();
+	}
+}
+
+/**
+ *  Add an object to the scene
+ */
+void Scene::AddObject(RTObject* o)
+{
+	lObjects.push_front(o);
+}
+
+/**
+ * Add an object to a scene whose grid is already built. Only the cells
+ * covered by the bounds of the object are updated, the distances of the
+ * cells are computed again by Refresh.
+ */
+void Scene::InsertObject(RTObject* o)
+{
+	lObjects.push_front(o);
+	o->SetIndex((int)m_Entries.size());
+	m_Entries.push_back(ObjectEntry());
+	AddPrimitive(o);
+	AddToGrid(o);
+	m_DistancesDirty = true;
+	m_BvhDirty = true;
+}
+
+/**
+ * Remove an object from the scene, its grid and its array of primitives. The
+ * last primitive of the array takes its place. The object isn't deleted and
+ * its index isn't given to another object.
+ */
+void Scene::RemoveObject(RTObject* o)
+{
+	if(o->GetIndex() < 0)
+		return;
+
+	RemoveFromGrid(o);
+	m_DistancesDirty = true;
+	RemovePrimitive(o);
+	lObjects.remove(o);
+	if(o->GetType() == RTObject::LIGHT)
+		m_Lights.erase(find(m_Lights.begin(), m_Lights.end(), o));
+
+	m_Entries[o->GetIndex()].type = -1;
+	o->SetIndex(-1);
+	m_BvhDirty = true;
+}
+
+/**
+ * Update the primitive and the cells of an object that was modified (moved,
+ * resized,...). Only the cells covered by its old and its new bounds are
+ * updated, the distances of the cells are computed again by Refresh.
+ */
+void Scene::UpdateObject(RTObject* o)
+{
+	if(o->GetIndex() < 0)
+		return;
+
+	RemoveFromGrid(o);
+	CopyPrimitive(o);
+	AddToGrid(o);
+	m_DistancesDirty = true;
+	m_BvhDirty = true;
+}
+
+/**
+ * Brings the structures traversed by the rays up to date after the edits of
+ * the objects (InsertObject, RemoveObject, UpdateObject), once for all the
+ * edits made since the last render. The distances of the cells are only
+ * needed when the grid is traversed, the BVH when it is traversed instead.
+ */
+void Scene::Refresh()
+{
+	if(m_DistancesDirty && m_Acceleration != ACCEL_BVH)
+		BuildDistances();
+	if(m_BvhDirty && m_Acceleration == ACCEL_BVH)
+		BuildBVH();
+}
+
+/**
+ * Add the primitive of an object at the end of the array of its type. The
+ * entry of the object must have been created.
+ */
+void Scene::AddPrimitive(RTObject* o)
+{
+	ObjectEntry& entry = m_Entries[o->GetIndex()];
+	switch(o->GetType())
+	{
+		case RTObject::LIGHT:
+			m_Lights.push_back(o);
+			// lights are intersected as spheres
+			// fall through
+		case RTObject::SPHERE:
+			entry.type = PRIM_SPHERE;
+			entry.prim = (int)m_Spheres.size();
+			m_Spheres.push_back(SphereData());
+			break;
+		case RTObject::PLANE:
+			entry.type = PRIM_PLANE;
+			entry.prim = (int)m_Planes.size();
+			m_Planes.push_back(PlaneData());
+			break;
+		case RTObject::TRIANGLE:
+			entry.type = PRIM_TRIANGLE;
+			entry.prim = (int)m_Triangles.size();
+			m_Triangles.push_back(TriangleData());
+			break;
+		case RTObject::SPHERE_CLOUD:
+			entry.type = PRIM_CLOUD;
+			entry.prim = (int)m_Clouds.size();
+			m_Clouds.push_back(CloudData());
+			break;
+		case RTObject::MESH_INSTANCE:
+			entry.type = PRIM_INSTANCE;
+			entry.prim = (int)m_Instances.size();
+			m_Instances.push_back(InstanceData());
+			break;
+		default:
+			entry.type = -1;
+			return;
+	}
+	CopyPrimitive(o);
+}
+
+/**
+ * Remove the primitive of an object from the array of its type by moving the
+ * last primitive in its place.
+ */
+void Scene::RemovePrimitive(RTObject* o)
+{
+	const ObjectEntry& entry = m_Entries[o->GetIndex()];
+	RTObject* moved = 0;
+	switch(entry.type)
+	{
+		case PRIM_SPHERE:	moved = RemoveFromArray(m_Spheres, entry.prim);	break;
+		case PRIM_PLANE:	moved = RemoveFromArray(m_Planes, entry.prim);		break;
+		case PRIM_TRIANGLE:	moved = RemoveFromArray(m_Triangles, entry.prim);	break;
+		case PRIM_CLOUD:	moved = RemoveFromArray(m_Clouds, entry.prim);		break;
+		case PRIM_INSTANCE:	moved = RemoveFromArray(m_Instances, entry.prim);	break;
+	}
+	if(moved)
+		RenumberPrimitive(moved, entry.prim);
+}
+
+/**
+ * Copy the data of an object into its primitive.
+ */
+void Scene::CopyPrimitive(RTObject* o)
+{
+	const ObjectEntry& entry = m_Entries[o->GetIndex()];
+	switch(entry.type)
+	{
+		case PRIM_SPHERE:
+		{
+			SphereData& s = m_Spheres[entry.prim];
+			s.center = o->GetPosition();
+			s.radius = ((Sphere*)o)->m_radius;
+			s.rayID = -1;
+			s.object = o;
+			break;
+		}
+		case PRIM_PLANE:
+		{
+			PlaneData& p = m_Planes[entry.prim];
+			p.N = ((Plane*)o)->m_N;
+			p.d = ((Plane*)o)->m_d;
+			p.rayID = -1;
+			p.object = o;
+			break;
+		}
+		case PRIM_TRIANGLE:
+		{
+			Triangle* tri = (Triangle*)o;
+			TriangleData& t = m_Triangles[entry.prim];
+			SetTriangleData(t, tri->GetVertex(0), tri->GetVertex(1), tri->GetVertex(2));
+			t.rayID = -1;
+			t.object = o;
+			break;
+		}
+		case PRIM_CLOUD:
+		{
+			CloudData& c = m_Clouds[entry.prim];
+			c.cloud = (SphereCloud*)o;
+			c.rayID = -1;
+			c.object = o;
+			break;
+		}
+		case PRIM_INSTANCE:
+		{
+			InstanceData& i = m_Instances[entry.prim];
+			i.instance = (MeshInstance*)o;
+			i.rayID = -1;
+			i.object = o;
+			break;
+		}
+	}
+}
+
+/**
+ * Change the index of the primitive of an object in the array of its type and
+ * in the cells referencing it.
+ */
+void Scene::RenumberPrimitive(RTObject* o, int prim)
+{
+	ObjectEntry& entry = m_Entries[o->GetIndex()];
+	for (int gZ = entry.cells[0][2]; gZ <= entry.cells[1][2]; gZ++)
+		for (int gY = entry.cells[0][1]; gY <= entry.cells[1][1]; gY++)
+			for (int gX = entry.cells[0][0]; gX <= entry.cells[1][0]; gX++)
 			{
-				int indexGrid = gX + gY * GRIDSIZE + gZ * GRIDSIZE *GRIDSIZE;
-				m_Grid[indexGrid] = 0;
-				//const Vector3 pos(gX,gY,gZ);
-				Vector3 pos(start.x + gX * dx, start.y + gY * dy, start.z + gZ * dz);				
-				
-				list<RTObject*>::iterator iObjects;
-				for( iObjects = lObjects.begin(); iObjects != lObjects.end(); iObjects++ )
+				vector<int>& prims = m_Grid[gX + gY * GRIDSIZE + gZ * GRIDSIZE * GRIDSIZE].m_Prims[entry.type];
+				replace(prims.begin(), prims.end(), entry.prim, prim);
+			}
+	entry.prim = prim;
+}
+
+/**
+ * Store a reference to the primitive of an object in the cells it intersects.
+ * Only the cells covered by the bounds of the object are tested.
+ */
+void Scene::AddToGrid(RTObject* o)
+{
+	ObjectEntry& entry = m_Entries[o->GetIndex()];
+	if(entry.type < 0)
+		return;
+
+	GetCellRange(o->GetBounds(), entry.cells);
+	const Vector3 start = m_box->GetMin();
+	for (int gZ = entry.cells[0][2]; gZ <= entry.cells[1][2]; gZ++)
+		for (int gY = entry.cells[0][1]; gY <= entry.cells[1][1]; gY++)
+			for (int gX = entry.cells[0][0]; gX <= entry.cells[1][0]; gX++)
+			{
+				Vector3 pos(start.x + gX * m_CellSize.x, start.y + gY * m_CellSize.y,
+					start.z + gZ * m_CellSize.z);
+				if(o->IntersectBoundingBox(pos, pos + m_CellSize))
+					m_Grid[gX + gY * GRIDSIZE + gZ * GRIDSIZE * GRIDSIZE].m_Prims[entry.type].push_back(entry.prim);
+			}
+}
+
+/**
+ * Compute the distance of each cell of the grid to the nearest non-empty cell
+ * (see GridCell::m_Distance). The Chebyshev distance is given exactly by two
+ * passes (chamfer) propagating the distances of the 13 neighbours already
+ * visited, in the order of the cells then in the reverse order. The cells
+ * beyond GRIDSIZE of any primitive keep GRIDSIZE : the rays skip the whole
+ * grid.
+ */
+void Scene::BuildDistances()
+{
+	const int nbCells = GRIDSIZE * GRIDSIZE * GRIDSIZE;
+	for(int i = 0; i < nbCells; i++)
+	{
+		GridCell& cell = m_Grid[i];
+		cell.m_Distance = GRIDSIZE;
+		for(int type = 0; type < PRIM_TYPES; type++)
+		{
+			if(!cell.m_Prims[type].empty())
+				cell.m_Distance = 0;
+		}
+	}
+
+	for(int pass = 0; pass < 2; pass++)
+	{
+		// forward pass : neighbours with a lower index, backward : higher
+		const int step = pass ? -1 : 1;
+		const int first = pass ? GRIDSIZE - 1 : 0;
+		for(int z = first; z >= 0 && z < GRIDSIZE; z += step)
+			for(int y = first; y >= 0 && y < GRIDSIZE; y += step)
+				for(int x = first; x >= 0 && x < GRIDSIZE; x += step)
 				{
-					if((*iObjects)->IntersectBoundingBox(pos, pos+size))
-					{
-						#ifdef DEBUG
-							cout << "Bounding box intersected : ";
-							cout << (*iObjects)->GetType() << " ";
-							cout << (*iObjects)->GetPosition();
-							cout << " " << gX << " " << gY << " " << gZ << "\n";
-						#endif
-						// Store a reference to the object in the list
-						ObjectList* l = new ObjectList();
-						l->SetRTObject(*iObjects);
-						l->SetNext(m_Grid[indexGrid]);
-						m_Grid[indexGrid] = l;
-					}			
+					int& distance = m_Grid[x + y * GRIDSIZE + z * GRIDSIZE * GRIDSIZE].m_Distance;
+					for(int dz = -1; dz <= 0; dz++)
+						for(int dy = -1; dy <= 1; dy++)
+							for(int dx = -1; dx <= 1; dx++)
+							{
+								// the 13 neighbours visited before the cell
+								if(dz == 0 && (dy > 0 || (dy == 0 && dx >= 0)))
+									continue;
+								int nx = x + step * dx, ny = y + step * dy, nz = z + step * dz;
+								if(nx < 0 || nx >= GRIDSIZE || ny < 0 || ny >= GRIDSIZE || nz < 0 || nz >= GRIDSIZE)
+									continue;
+								int neighbour = m_Grid[nx + ny * GRIDSIZE + nz * GRIDSIZE * GRIDSIZE].m_Distance;
+								if(neighbour + 1 < distance)
+									distance = neighbour + 1;
+							}
 				}
+	}
+	m_DistancesDirty = false;
+}
+
+/**
+ * Remove the references to the primitive of an object from the cells in which
+ * AddToGrid stored them.
+ */
+void Scene::RemoveFromGrid(RTObject* o)
+{
+	const ObjectEntry& entry = m_Entries[o->GetIndex()];
+	if(entry.type < 0)
+		return;
+
+	for (int gZ = entry.cells[0][2]; gZ <= entry.cells[1][2]; gZ++)
+		for (int gY = entry.cells[0][1]; gY <= entry.cells[1][1]; gY++)
+			for (int gX = entry.cells[0][0]; gX <= entry.cells[1][0]; gX++)
+			{
+				vector<int>& prims = m_Grid[gX + gY * GRIDSIZE + gZ * GRIDSIZE * GRIDSIZE].m_Prims[entry.type];
+				vector<int>::iterator it = find(prims.begin(), prims.end(), entry.prim);
+				if(it != prims.end())
+					prims.erase(it);
 			}
 }
 
 /**
- *  Add an object to the scene
+ * Compute the range of cells covered by a bounding box, with a margin of one
+ * cell on each side for the cells that only touch it. The range is empty
+ * (first > last) for an empty box.
  */
-void Scene::AddObject(RTObject* o)
+void Scene::GetCellRange(const Box& bounds, int cells[2][3]) const
 {
-	lObjects.push_front(o);
+	const Vector3 start = m_box->GetMin();
+	const Vector3 v1 = bounds.GetMin(), v2 = bounds.GetMax();
+	for(int a = 0; a < 3; a++)
+	{
+		cells[0][a] = max(GetCell(((&v1.x)[a] - (&start.x)[a]) / (&m_CellSize.x)[a]) - 1, 0);
+		cells[1][a] = min(GetCell(((&v2.x)[a] - (&start.x)[a]) / (&m_CellSize.x)[a]) + 1, GRIDSIZE - 1);
+	}
 }
 
 /**
  * Imports the ASE model contained in the file whose name is specified in
- * strFileName
+ * strFileName. Each face becomes a Triangle object, moved by 2 along z (see
+ * LoadMesh to place a model several times).
  * @param strFileName file name that contains the ASE model to be imported
  */
 void Scene::ImportASE(char *strFileName)
@@ -124,9 +560,7 @@ void Scene::ImportASE(char *strFileName)
         // Go through all of the faces (polygons) of the object and draw them
         for(int j = 0; j < pObj->numOfFaces; j++)
         {
-#ifdef VERTEX_NORMAL        	
         	Vector3 vNormals[3];
-#endif
         	Vector3 vectors[3];
             // Go through each corner of the triangle and draw it.
             for(int whichVertex = 0; whichVertex < 3; whichVertex++)
@@ -139,17 +573,12 @@ void Scene::ImportASE(char *strFileName)
 					pObj->pVerts[vertIndex].y,
 					pObj->pVerts[vertIndex].z + 2.0f);
 				
-#ifdef VERTEX_NORMAL        	
 				vNormals[whichVertex] = Vector3(pObj->pNormals[vertIndex].x,
 					pObj->pNormals[vertIndex].y,
 					pObj->pNormals[vertIndex].z);
-#endif				
             }
 			Triangle* t=new Triangle(vectors[0], vectors[1], vectors[2]);
-			
-#ifdef VERTEX_NORMAL
 			t->SetVertexNormals(vNormals);
-#endif			
 			
 			// TODO : should use the material from the ASE model
 			t->GetMaterial()->SetColor(objColor);
@@ -160,3 +589,70 @@ void Scene::ImportASE(char *strFileName)
         i++;
 	}
 }
+
+/**
+ * Loads the ASE model contained in the file whose name is specified in
+ * strFileName as a mesh that can be placed several times in the scene (see
+ * MeshInstance). Unlike ImportASE, the triangles are kept in the space of the
+ * model and are stored only once : the file is loaded the first time only.
+ * @param split method used to build the BVH of the mesh when the file is
+ * loaded (see Mesh::SetSplitMethod).
+ * @return the mesh, owned by the scene (empty if the file has no object).
+ */
+Mesh* Scene::LoadMesh(const char* strFileName, BVHSplit split)
+{
+	map<string, Mesh*>::iterator iMesh = m_Meshes.find(strFileName);
+	if(iMesh != m_Meshes.end())
+		return iMesh->second;
+
+	Mesh* mesh = new Mesh;
+	mesh->SetSplitMethod(split);
+	m_Meshes[strFileName] = mesh;
+
+	CLoadASE loadASE;
+	t3DModel model;
+	string fileName(strFileName);
+	loadASE.ImportASE(&model, &fileName[0]);
+
+	std::vector<t3DObject>::iterator itObject;
+	for(itObject = model.pObject.begin(); itObject != model.pObject.end(); itObject++)
+	{
+		t3DObject *pObj = &(*itObject);
+		// a mesh has a single material : the one of the first object
+		if(itObject == model.pObject.begin())
+		{
+			float* fColor = model.pMaterials[pObj->materialID].fColor;
+			mesh->SetColor(Color(fColor[0], fColor[1], fColor[2]));
+		}
+
+		for(int j = 0; j < pObj->numOfFaces; j++)
+		{
+			Vector3 vectors[3], vNormals[3];
+			for(int whichVertex = 0; whichVertex < 3; whichVertex++)
+			{
+				int vertIndex = pObj->pFaces[j].vertIndex[whichVertex];
+				vectors[whichVertex] = Vector3(pObj->pVerts[vertIndex].x,
+					pObj->pVerts[vertIndex].y, pObj->pVerts[vertIndex].z);
+				vNormals[whichVertex] = Vector3(pObj->pNormals[vertIndex].x,
+					pObj->pNormals[vertIndex].y, pObj->pNormals[vertIndex].z);
+			}
+			mesh->AddTriangle(vectors, vNormals);
+		}
+	}
+	mesh->Build();
+	return mesh;
+}
+
+/**
+ * @param prim index of the primitive in the BVH of the scene (see
+ * Scene::GetBVHPrims).
+ */
+Box SceneClipper::Clip(int prim, const Box& box) const
+{
+	const PrimRef& ref = m_Scene.GetBVHPrims()[prim];
+	if(ref.type != PRIM_TRIANGLE)
+		return box;
+	Triangle* triangle = (Triangle*)m_Scene.GetTriangles()[ref.prim].object;
+	return ClipTriangle(triangle->GetVertex(0), triangle->GetVertex(1),
+		triangle->GetVertex(2), box);
+}
@@ -13,30 +13,84 @@
 //-------------------------------------------------------------------- INCLUDES
 
 #include "rtObjects.h"
+#include "primitives.h"
+#include "mesh.h"
 
 #include <iostream>
 #include <list>
+#include <map>
+#include <string>
+#include <vector>
 using namespace std;
 
+//---------------------------------------------------------------------- CONSTS
+
+// maximum number of primitives in a leaf of the BVH of the scene
+#define SCENE_LEAF_SIZE 2
+
+//----------------------------------------------------------------------- TYPES
+
+// Structure traversed by RayTracer::FindNearest (see Scene::SetAcceleration)
+enum SceneAcceleration
+{
+	ACCEL_GRID = 0,
+	ACCEL_BVH
+};
+
 //----------------------------------------------------------------------- CLASS
 
+class Scene;
+
 // ----------------------------------------------------------------------------
-// Object list helper class (similar to the std:multimap class).
-// The order of insertion is maintained
+// Clips the triangles referenced by the BVH of the scene for its spatial
+// splits, the other primitives only have their bounds (see BVHClipper)
 // ----------------------------------------------------------------------------
 
-class ObjectList
+class SceneClipper : public BVHClipper
 {
 public:
-	ObjectList() : m_RTObject( 0 ), m_Next( 0 ) {}
-	~ObjectList() { delete m_Next; }
-	void SetRTObject( RTObject* a_obj ) { m_RTObject = a_obj; }
-	RTObject* GetRTObject() { return m_RTObject; }
-	void SetNext( ObjectList* a_Next ) { m_Next = a_Next; }
-	ObjectList* GetNext() { return m_Next; }
+	SceneClipper(Scene& scene):m_Scene(scene){}
+
+	Box Clip(int prim, const Box& box) const;
+
 private:
-	RTObject* m_RTObject;
-	ObjectList* m_Next;
+	Scene& m_Scene;
+};
+
+// ----------------------------------------------------------------------------
+// Cell of the grid used for the spatial division. A cell references the
+// primitives intersecting it by their index in the array of their type.
+// ----------------------------------------------------------------------------
+
+struct GridCell
+{
+	vector<int> m_Prims[PRIM_TYPES];
+	// Chebyshev distance in cells to the nearest cell referencing a
+	// primitive (0 for such a cell) : the cells nearer than m_Distance are
+	// empty, so the rays can skip them (see RayTracer::FindNearest)
+	int m_Distance;
+};
+
+// ----------------------------------------------------------------------------
+// Place of an object in the arrays of primitives and in the grid, so that it
+// can be updated without building the grid again (see Scene::UpdateObject).
+// ----------------------------------------------------------------------------
+
+struct ObjectEntry
+{
+	int type; // type of the primitive (-1 if the object was removed)
+	int prim; // index of the primitive in the array of its type
+	int cells[2][3]; // first and last cells of the range covering its bounds
+};
+
+// ----------------------------------------------------------------------------
+// Primitive referenced by the BVH of the scene
+// ----------------------------------------------------------------------------
+
+struct PrimRef
+{
+	int type; // type of the primitive
+	int prim; // index of the primitive in the array of its type
 };
 
 // ----------------------------------------------------------------------------
@@ -48,19 +102,73 @@ class Scene
 public:
 	Scene();
 	virtual ~Scene();
+	void BuildPrimitives();
 	void BuildGrid();
+	void BuildBVH();
 	
 	void AddObject(RTObject* o);	
+	void InsertObject(RTObject* o);
+	void RemoveObject(RTObject* o);
+	void UpdateObject(RTObject* o);
+	void Refresh();
+	// number of indices given to the objects (see RTObject::GetIndex)
+	int GetNbIndices() const {return (int)m_Entries.size();}
 	Box& GetBox() {return *m_box;}
-	ObjectList** GetGrid() {return m_Grid;}
+	GridCell* GetGrid() {return m_Grid;}
+	SceneAcceleration GetAcceleration() const {return m_Acceleration;}
+	void SetAcceleration(SceneAcceleration accel, BVHSplit split = BVH_SPLIT_MORTON,
+		bool quantized = false);
+	const BVH& GetBVH() const {return m_Bvh;}
+	const WideBVH& GetWideBVH() const {return m_WideBvh;}
+	const vector<PrimRef>& GetBVHPrims() const {return m_BvhPrims;}
 	list<RTObject*>& GetObjects() {return lObjects;}
+	vector<RTObject*>& GetLights() {return m_Lights;}
+	vector<SphereData>& GetSpheres() {return m_Spheres;}
+	vector<PlaneData>& GetPlanes() {return m_Planes;}
+	vector<TriangleData>& GetTriangles() {return m_Triangles;}
+	vector<CloudData>& GetClouds() {return m_Clouds;}
+	vector<InstanceData>& GetInstances() {return m_Instances;}
 	void ImportASE(char *strFileName);
+	Mesh* LoadMesh(const char* strFileName, BVHSplit split = BVH_SPLIT_SAH);
 	
 private:
+	void AddPrimitive(RTObject* o);
+	void RemovePrimitive(RTObject* o);
+	void CopyPrimitive(RTObject* o);
+	void RenumberPrimitive(RTObject* o, int prim);
+	void AddToGrid(RTObject* o);
+	void RemoveFromGrid(RTObject* o);
+	void GetCellRange(const Box& bounds, int cells[2][3]) const;
+	void BuildDistances();
+
 	// list of the objects that belong to the scene
 	list<RTObject*> lObjects;
+	// primitives built from the objects (see BuildPrimitives)
+	vector<SphereData> m_Spheres;
+	vector<PlaneData> m_Planes;
+	vector<TriangleData> m_Triangles;
+	vector<CloudData> m_Clouds;
+	vector<InstanceData> m_Instances;
+	vector<RTObject*> m_Lights;
+	// meshes loaded by LoadMesh, indexed by file name
+	map<string, Mesh*> m_Meshes;
+	// entry of each object, indexed by RTObject::GetIndex
+	vector<ObjectEntry> m_Entries;
 	// Structure used for the spatial division
-	ObjectList** m_Grid;
+	GridCell* m_Grid;
+	Vector3 m_CellSize;
+	// the distances of the cells are out of date after the edits (see Refresh)
+	bool m_DistancesDirty;
+	// BVH over the bounded primitives (the planes are tested by every ray),
+	// built again by Refresh after the edits when it is selected, and the
+	// 4-wide BVH collapsed from it and traversed by the rays
+	SceneAcceleration m_Acceleration;
+	BVH m_Bvh;
+	WideBVH m_WideBvh;
+	bool m_QuantizedBVH; // bounds of the wide BVH stored on 8 bits
+	vector<PrimRef> m_BvhPrims; // primitive referenced by each index of m_Bvh
+	bool m_BvhDirty; // the BVH is out of date after the edits
+	SceneClipper m_Clipper;
 	// bounding box surrounding the scene
 	Box* m_box;	
 };
@@ -0,0 +1,287 @@
+/**
+* File : sphereCloud.cpp
+* Description : Large set of spheres sharing the same material.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "sphereCloud.h"
+#include "primitives.h"
+#include "defs.h"
+
+//--------------------------------------------------------------------- METHODS
+
+/**
+ * Adds a sphere to the cloud. Build must be called once all the spheres have
+ * been added.
+ */
+void SphereCloud::AddSphere(const Vector3& center, float radius)
+{
+	// remove the padding of a previous build
+	m_X.resize(m_nbSpheres);
+	m_Y.resize(m_nbSpheres);
+	m_Z.resize(m_nbSpheres);
+	m_R2.resize(m_nbSpheres);
+
+	m_Order.push_back(m_nbSpheres);
+	m_X.push_back(center.x);
+	m_Y.push_back(center.y);
+	m_Z.push_back(center.z);
+	m_R2.push_back(radius * radius);
+	m_nbSpheres++;
+}
+
+/**
+ * Build the BVH of the cloud and sort the spheres in the order of its leaves.
+ */
+void SphereCloud::Build()
+{
+	vector<Box> bounds(m_nbSpheres);
+	for(int i = 0; i < m_nbSpheres; i++)
+		bounds[i] = GetSphereBounds(i);
+	m_Bvh.Build(bounds, CLOUD_LEAF_SIZE);
+
+	// reorder the spheres so that each leaf references contiguous spheres
+	const vector<int>& indices = m_Bvh.GetIndices();
+	vector<float> x(m_nbSpheres), y(m_nbSpheres), z(m_nbSpheres), r2(m_nbSpheres);
+	vector<int> order(m_nbSpheres);
+	for(int i = 0; i < m_nbSpheres; i++)
+	{
+		x[i] = m_X[indices[i]];
+		y[i] = m_Y[indices[i]];
+		z[i] = m_Z[indices[i]];
+		r2[i] = m_R2[indices[i]];
+		order[i] = m_Order[indices[i]];
+	}
+	m_X.swap(x);
+	m_Y.swap(y);
+	m_Z.swap(z);
+	m_R2.swap(r2);
+	m_Order.swap(order);
+
+	// padding : spheres that can't be hit
+	m_X.resize(m_nbSpheres + KERNEL_MAX_WIDTH, 0);
+	m_Y.resize(m_nbSpheres + KERNEL_MAX_WIDTH, 0);
+	m_Z.resize(m_nbSpheres + KERNEL_MAX_WIDTH, 0);
+	m_R2.resize(m_nbSpheres + KERNEL_MAX_WIDTH, -1.0f);
+
+	CopyNodes();
+}
+
+/**
+ * Moves the spheres of a built cloud. Refit must be called afterwards.
+ * @param centers new center of each sphere, in the order of AddSphere.
+ */
+void SphereCloud::SetCenters(const vector<Vector3>& centers)
+{
+	for(int i = 0; i < m_nbSpheres; i++)
+	{
+		const Vector3& c = centers[m_Order[i]];
+		m_X[i] = c.x;
+		m_Y[i] = c.y;
+		m_Z[i] = c.z;
+	}
+}
+
+/**
+ * Updates the bounds of the BVH after the spheres moved, keeping its tree.
+ * If its cost has degraded by more than GetMaxDegradation since the last
+ * build, the BVH is built again.
+ * @return true if the BVH was built again.
+ */
+bool SphereCloud::Refit()
+{
+	if(m_Bvh.IsEmpty())
+		return false;
+
+	// bounds in the order of the spheres given to the last build
+	const vector<int>& indices = m_Bvh.GetIndices();
+	vector<Box> bounds(m_nbSpheres);
+	for(int i = 0; i < m_nbSpheres; i++)
+		bounds[indices[i]] = GetSphereBounds(i);
+	m_Bvh.Refit(bounds);
+
+	if(m_Bvh.GetDegradation() > m_maxDegradation)
+	{
+		Build();
+		return true;
+	}
+	CopyNodes();
+	return false;
+}
+
+/**
+ * Moves all the spheres and refits the BVH (a translation doesn't change its
+ * cost).
+ */
+void SphereCloud::Translate(const Vector3& offset)
+{
+	for(int i = 0; i < m_nbSpheres; i++)
+	{
+		m_X[i] += offset.x;
+		m_Y[i] += offset.y;
+		m_Z[i] += offset.z;
+	}
+	m_pos += offset;
+	Refit();
+}
+
+Box SphereCloud::GetSphereBounds(int i) const
+{
+	float r = sqrtf(m_R2[i]);
+	Vector3 c(m_X[i], m_Y[i], m_Z[i]);
+	Box bounds;
+	bounds.Extend(c - Vector3(r, r, r));
+	bounds.Extend(c + Vector3(r, r, r));
+	return bounds;
+}
+
+/**
+ * Copy the nodes of the BVH for the kernels.
+ */
+void SphereCloud::CopyNodes()
+{
+	const vector<BVHNode>& nodes = m_Bvh.GetNodes();
+	m_Nodes.resize(nodes.size());
+	for(size_t i = 0; i < nodes.size(); i++)
+	{
+		Vector3 v1 = nodes[i].bounds.GetMin(), v2 = nodes[i].bounds.GetMax();
+		for(int a = 0; a < 3; a++)
+		{
+			m_Nodes[i].bounds[0][a] = v1[a];
+			m_Nodes[i].bounds[1][a] = v2[a];
+		}
+		m_Nodes[i].first = nodes[i].first;
+		m_Nodes[i].count = nodes[i].count;
+	}
+}
+
+/**
+ * Finds the nearest intersection between the spheres and the specified ray.
+ * @param tmin the intersections nearer than tmin are ignored.
+ * @return std::numeric_limits<float>::infinity() if no intersection detected.
+ * Otherwise the distance between the intersected sphere and the origin of the
+ * ray is returned.
+ */
+float SphereCloud::IntersectCloud(const Ray& ray, float tmin)
+{
+	m_rayID = ray.GetID();
+	if(m_Nodes.empty())
+		return std::numeric_limits<float>::infinity();
+
+	KernelSpheres spheres;
+	spheres.nodes = &m_Nodes[0];
+	spheres.x = &m_X[0];
+	spheres.y = &m_Y[0];
+	spheres.z = &m_Z[0];
+	spheres.r2 = &m_R2[0];
+
+	KernelRay r;
+	Vector3 o = ray.GetOrigin(), d = ray.GetDirection();
+	const Vector3& inv = ray.GetInvDirection();
+	for(int a = 0; a < 3; a++)
+	{
+		r.origin[a] = o[a];
+		r.dir[a] = d[a];
+		r.invDir[a] = (&inv.x)[a];
+		r.sign[a] = ray.GetSign(a);
+	}
+	r.tmin = tmin;
+	return GetKernels().IntersectSpheres(spheres, r);
+}
+
+/**
+ * @return the normal of the sphere on which lies the point pos (the sphere
+ * whose surface is the closest to pos).
+ */
+Vector3 SphereCloud::GetNormal(Vector3& pos)
+{
+	const vector<BVHNode>& nodes = m_Bvh.GetNodes();
+	if(nodes.empty())
+		return NULLVECTOR3;
+
+	float nearest = std::numeric_limits<float>::infinity();
+	Vector3 normal;
+	// the point lies on the surface : only the leaves whose bounds contain it
+	// (with a margin for the rounding errors) have to be checked
+	Vector3 margin(EPSILON, EPSILON, EPSILON);
+	Vector3 v1 = pos - margin, v2 = pos + margin;
+
+	int stack[BVH_STACK_SIZE];
+	int nbNodes = 0;
+	stack[nbNodes++] = 0;
+	while(nbNodes > 0)
+	{
+		int index = stack[--nbNodes];
+		const BVHNode& node = nodes[index];
+		if(!node.bounds.Overlaps(v1, v2))
+			continue;
+		if(node.count == 0)
+		{
+			stack[nbNodes++] = node.first;
+			stack[nbNodes++] = index + 1;
+			continue;
+		}
+		for(int i = node.first; i < node.first + node.count; i++)
+		{
+			Vector3 n = pos - Vector3(m_X[i], m_Y[i], m_Z[i]);
+			float dist = fabsf(n.LengthSq() - m_R2[i]);
+			if(dist < nearest)
+			{
+				nearest = dist;
+				normal = n;
+			}
+		}
+	}
+	return normal;
+}
+
+/**
+ * Checks if any sphere of the cloud intersects the specified bounding box.
+ * @param v1 lower left corner.
+ * @param v2 upper right corner.
+ * @return true on success, false otherwise.
+ */
+bool SphereCloud::IntersectBoundingBox(const Vector3& v1, const Vector3& v2)
+{
+	const vector<BVHNode>& nodes = m_Bvh.GetNodes();
+	if(nodes.empty())
+		return false;
+
+	int stack[BVH_STACK_SIZE];
+	int nbNodes = 0;
+	stack[nbNodes++] = 0;
+	while(nbNodes > 0)
+	{
+		int index = stack[--nbNodes];
+		const BVHNode& node = nodes[index];
+		if(!node.bounds.Overlaps(v1, v2))
+			continue;
+		if(node.count == 0)
+		{
+			stack[nbNodes++] = node.first;
+			stack[nbNodes++] = index + 1;
+			continue;
+		}
+		for(int i = node.first; i < node.first + node.count; i++)
+		{
+			// distance between the center and the box
+			float c[3] = { m_X[i], m_Y[i], m_Z[i] };
+			float dmin = 0;
+			for(int a = 0; a < 3; a++)
+			{
+				const float lo = (&v1.x)[a], hi = (&v2.x)[a];
+				if(c[a] < lo)
+					dmin += (c[a] - lo) * (c[a] - lo);
+				else if(c[a] > hi)
+					dmin += (c[a] - hi) * (c[a] - hi);
+			}
+			if(dmin <= m_R2[i])
+				return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,75 @@
+/**
+* File : sphereCloud.h
+* Description : Large set of spheres sharing the same material (particles,
+* atoms of a molecule,...). The centers and the radii are stored in separate
+* arrays (structure of arrays) ordered by the leaves of a BVH, so a leaf of up
+* to 8 spheres can be intersected at once (see IntersectSpheres in kernels.h).
+* Animated clouds move their spheres with SetCenters : the BVH is refitted
+* and only built again once its cost has degraded too much (see Refit).
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef SPHERECLOUD_H
+#define SPHERECLOUD_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "rtObjects.h"
+#include "bvh.h"
+#include "kernels.h"
+
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------- CONSTS
+
+// number of spheres tested at once (size of the leaves of the BVH)
+#define CLOUD_LEAF_SIZE 8
+
+// distance under which a ray starting from a cloud doesn't hit it
+#define CLOUD_SELF_DISTANCE 1e-3f
+
+//----------------------------------------------------------------------- CLASS
+
+class SphereCloud : public RTObject
+{
+public:
+	SphereCloud():RTObject(NULLVECTOR3, SPHERE_CLOUD),m_nbSpheres(0),
+		m_maxDegradation(BVH_MAX_DEGRADATION){}
+
+	void AddSphere(const Vector3& center, float radius);
+	void Build();
+	void SetCenters(const vector<Vector3>& centers);
+	bool Refit();
+	int GetNbSpheres() const { return m_nbSpheres; }
+	float GetMaxDegradation() const { return m_maxDegradation; }
+	void SetMaxDegradation(float degradation) { m_maxDegradation = degradation; }
+	const BVH& GetBVH() const { return m_Bvh; }
+	Box GetBounds() const { return m_Bvh.GetBounds(); }
+	void Translate(const Vector3& offset);
+
+	float IntersectCloud(const Ray& ray, float tmin = 0);
+	float Intersect(const Ray& ray) { return IntersectCloud(ray); }
+	Vector3 GetNormal(Vector3& pos);
+	bool IntersectBoundingBox(const Vector3& v1, const Vector3& v2);
+
+private:
+	Box GetSphereBounds(int i) const;
+	void CopyNodes();
+
+	int m_nbSpheres;
+	// centers and square radii, ordered by the leaves of the BVH once built.
+	// The arrays are padded so that a full packet can always be loaded.
+	vector<float> m_X, m_Y, m_Z, m_R2;
+	// order in which each sphere was added (see SetCenters)
+	vector<int> m_Order;
+	BVH m_Bvh;
+	// degradation of the BVH above which Refit builds it again
+	float m_maxDegradation;
+	// copy of the nodes of the BVH given to the kernels
+	vector<KernelNode> m_Nodes;
+};
+
+#endif // SPHERECLOUD_H
@@ -0,0 +1,165 @@
+/**
+* File : wideBvh.cpp
+* Description : 4-wide bounding volume hierarchy collapsed from a binary BVH.
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+//-------------------------------------------------------------------- INCLUDES
+#include "wideBvh.h"
+#include "defs.h"
+
+#include <algorithm>
+
+//--------------------------------------------------------------------- HELPERS
+
+/**
+ * @return the number of steps of size scale from origin to f, rounded down
+ * (roundUp false) or up so that the quantized value still contains f.
+ */
+static unsigned char QuantizeBound(float f, float origin, float scale, bool roundUp)
+{
+	if(scale <= 0)
+		return 0;
+	float steps = (f - origin) / scale;
+	int q = roundUp ? (int)ceilf(steps) : (int)floorf(steps);
+	q = (q < 0) ? 0 : ((q > 255) ? 255 : q);
+	// rounding errors of the decoding (origin + q * scale)
+	while(!roundUp && q > 0 && origin + q * scale > f)
+		q--;
+	while(roundUp && q < 255 && origin + q * scale < f)
+		q++;
+	return (unsigned char)q;
+}
+
+//--------------------------------------------------------------------- METHODS
+
+/**
+ * Collapse a binary BVH : each node takes the children of its largest inner
+ * children until it has WIDE_BVH_WIDTH children. The leaves are kept.
+ * @param quantized stores the bounds of the children on 8 bits.
+ */
+void WideBVH::Build(const BVH& bvh, bool quantized)
+{
+	Clear();
+	m_Quantized = quantized;
+	const vector<BVHNode>& nodes = bvh.GetNodes();
+	if(nodes.empty())
+		return;
+
+	m_Nodes.reserve(nodes.size() / 2 + 1);
+	CollapseNode(nodes, 0);
+	if(quantized)
+		Quantize();
+}
+
+/**
+ * Build the node whose children are taken under the binary node index.
+ * @return index of the node.
+ */
+int WideBVH::CollapseNode(const vector<BVHNode>& nodes, int index)
+{
+	int wide = (int)m_Nodes.size();
+	m_Nodes.push_back(WideNode());
+
+	int children[WIDE_BVH_WIDTH];
+	int nbChildren = 0;
+	if(nodes[index].count > 0)
+		children[nbChildren++] = index;
+	else
+	{
+		children[nbChildren++] = index + 1;
+		children[nbChildren++] = nodes[index].first;
+	}
+	while(nbChildren < WIDE_BVH_WIDTH)
+	{
+		// the largest inner child is opened (the most often hit)
+		int largest = -1;
+		float largestArea = -1;
+		for(int k = 0; k < nbChildren; k++)
+		{
+			const BVHNode& child = nodes[children[k]];
+			if(child.count == 0 && child.bounds.GetArea() > largestArea)
+			{
+				largest = k;
+				largestArea = child.bounds.GetArea();
+			}
+		}
+		if(largest < 0)
+			break;
+		int opened = children[largest];
+		children[largest] = opened + 1;
+		children[nbChildren++] = nodes[opened].first;
+	}
+
+	const float inf = std::numeric_limits<float>::infinity();
+	for(int k = 0; k < WIDE_BVH_WIDTH; k++)
+	{
+		Vector3 min(inf, inf, inf), max(-inf, -inf, -inf);
+		int child = 0, count = -1;
+		if(k < nbChildren)
+		{
+			const BVHNode& node = nodes[children[k]];
+			min = node.bounds.GetMin();
+			max = node.bounds.GetMax();
+			count = node.count;
+			// the array of nodes grows : the node is written after the recursion
+			child = (count > 0) ? node.first : CollapseNode(nodes, children[k]);
+		}
+		WideNode& node = m_Nodes[wide];
+		node.bounds[0][k] = min.x;
+		node.bounds[1][k] = min.y;
+		node.bounds[2][k] = min.z;
+		node.bounds[3][k] = max.x;
+		node.bounds[4][k] = max.y;
+		node.bounds[5][k] = max.z;
+		node.child[k] = child;
+		node.count[k] = count;
+	}
+	return wide;
+}
+
+/**
+ * Convert the nodes to quantized nodes, the step of each axis dividing the
+ * box of the node in 255 steps.
+ */
+void WideBVH::Quantize()
+{
+	m_QNodes.resize(m_Nodes.size());
+	for(size_t i = 0; i < m_Nodes.size(); i++)
+	{
+		const WideNode& node = m_Nodes[i];
+		QuantizedNode& q = m_QNodes[i];
+		for(int a = 0; a < 3; a++)
+		{
+			float min = std::numeric_limits<float>::infinity();
+			float max = -min;
+			for(int k = 0; k < WIDE_BVH_WIDTH; k++)
+			{
+				if(node.count[k] < 0)
+					continue;
+				min = std::min(min, node.bounds[a][k]);
+				max = std::max(max, node.bounds[3 + a][k]);
+			}
+			q.origin[a] = min;
+			q.scale[a] = (max - min) / 255.0f;
+			// the last step must reach the upper bound despite the rounding
+			while(q.scale[a] > 0 && min + 255.0f * q.scale[a] < max)
+				q.scale[a] = nextafterf(q.scale[a], std::numeric_limits<float>::infinity());
+		}
+		for(int k = 0; k < WIDE_BVH_WIDTH; k++)
+		{
+			// the empty slots keep null bounds, they are skipped by their count
+			for(int a = 0; a < 3 && node.count[k] >= 0; a++)
+			{
+				q.bounds[a][k] = QuantizeBound(node.bounds[a][k], q.origin[a], q.scale[a], false);
+				q.bounds[3 + a][k] = QuantizeBound(node.bounds[3 + a][k], q.origin[a], q.scale[a], true);
+			}
+			q.child[k] = node.child[k];
+			q.count[k] = node.count[k];
+		}
+	}
+	vector<WideNode>().swap(m_Nodes);
+}
@@ -0,0 +1,220 @@
+/**
+* File : wideBvh.h
+* Description : 4-wide bounding volume hierarchy collapsed from a binary BVH.
+* The bounds of the 4 children of a node are stored as a structure of arrays,
+* so a single SIMD slab test tells which children the ray hits, and a node
+* fits in two cache lines (one and a half when the bounds are quantized to 8
+* bits relative to the node, see Build). The leaves reference the same ranges
+* of primitive indices as the binary BVH, so the same leaf tests are used (see
+* BVH::Intersect).
+*
+* Author(s) : ALucchi
+* Date of creation : 18/10/2026
+* Modification(s) :
+*/
+
+#ifndef WIDEBVH_H
+#define WIDEBVH_H
+
+//-------------------------------------------------------------------- INCLUDES
+#include "bvh.h"
+#include "Maths/Vector3xN.h"
+
+#include <vector>
+using namespace std;
+
+//---------------------------------------------------------------------- CONSTS
+
+// number of children of a node (lanes of a slab test)
+#define WIDE_BVH_WIDTH 4
+
+// size of the traversal stack : each node pushes at most its 4 children
+#define WIDE_BVH_STACK_SIZE (BVH_STACK_SIZE * (WIDE_BVH_WIDTH - 1) + 1)
+
+//----------------------------------------------------------------------- TYPES
+
+// ----------------------------------------------------------------------------
+// Node of the hierarchy (128 bytes). An empty slot has a count of -1 and an
+// empty box.
+// ----------------------------------------------------------------------------
+
+struct WideNode
+{
+	// min x, y, z then max x, y, z of each child
+	float bounds[6][WIDE_BVH_WIDTH];
+	int child[WIDE_BVH_WIDTH]; // leaf : index of the first primitive, inner node : node
+	int count[WIDE_BVH_WIDTH]; // number of primitives of a leaf (0 for an inner node)
+};
+
+// ----------------------------------------------------------------------------
+// Same node with the bounds of the children quantized to 8 bits in the box of
+// the node (80 bytes). The bounds are rounded outwards, so a ray hitting a
+// child always hits its quantized box.
+// ----------------------------------------------------------------------------
+
+struct QuantizedNode
+{
+	float origin[3]; // lower corner of the node
+	float scale[3]; // size of a quantization step
+	unsigned char bounds[6][WIDE_BVH_WIDTH];
+	int child[WIDE_BVH_WIDTH];
+	int count[WIDE_BVH_WIDTH];
+};
+
+//----------------------------------------------------------------------- CLASS
+
+// ----------------------------------------------------------------------------
+// WideBVH class
+// ----------------------------------------------------------------------------
+
+class WideBVH
+{
+public:
+	WideBVH():m_Quantized(false){}
+
+	void Build(const BVH& bvh, bool quantized = false);
+	void Clear() { m_Nodes.clear(); m_QNodes.clear(); }
+
+	bool IsEmpty() const { return m_Nodes.empty() && m_QNodes.empty(); }
+	bool IsQuantized() const { return m_Quantized; }
+	int GetNbNodes() const { return (int)(m_Quantized ? m_QNodes.size() : m_Nodes.size()); }
+	// size of the nodes in bytes
+	int GetMemory() const { return (int)(m_Nodes.size() * sizeof(WideNode)
+		+ m_QNodes.size() * sizeof(QuantizedNode)); }
+
+	template <class LeafTest>
+	float Intersect(const Ray& ray, LeafTest& test,
+		float tmax = std::numeric_limits<float>::infinity()) const;
+
+private:
+	int CollapseNode(const vector<BVHNode>& nodes, int index);
+	void Quantize();
+
+	template <class Node, class LeafTest>
+	float IntersectNodes(const vector<Node>& nodes, const Ray& ray, LeafTest& test,
+		float tmax) const;
+
+	vector<WideNode> m_Nodes;
+	vector<QuantizedNode> m_QNodes;
+	bool m_Quantized;
+};
+
+//--------------------------------------------------------------------- INLINES
+
+/**
+ * Loads the bounds of the children of a node (see WideNode::bounds).
+ */
+inline void LoadBounds(const WideNode& node, Float4 bounds[6])
+{
+	for(int i = 0; i < 6; i++)
+		bounds[i] = Load<Float4>(node.bounds[i]);
+}
+
+inline void LoadBounds(const QuantizedNode& node, Float4 bounds[6])
+{
+	for(int i = 0; i < 6; i++)
+	{
+		const unsigned char* q = node.bounds[i];
+		Int4 steps = {q[0], q[1], q[2], q[3]};
+		bounds[i] = Splat<Float4>(node.origin[i % 3])
+			+ __builtin_convertvector(steps, Float4) * Splat<Float4>(node.scale[i % 3]);
+	}
+}
+
+/**
+ * Finds the nearest intersection between the ray and the primitives of the
+ * hierarchy. The children hit by the ray are visited from the nearest.
+ * @param test functor called for each leaf hit by the ray (see
+ * BVH::Intersect).
+ * @param tmax the nodes farther than tmax are skipped.
+ * @return tmax if no nearer intersection detected.
+ */
+template <class LeafTest>
+float WideBVH::Intersect(const Ray& ray, LeafTest& test, float tmax) const
+{
+	return m_Quantized ? IntersectNodes(m_QNodes, ray, test, tmax)
+		: IntersectNodes(m_Nodes, ray, test, tmax);
+}
+
+template <class Node, class LeafTest>
+float WideBVH::IntersectNodes(const vector<Node>& nodes, const Ray& ray, LeafTest& test,
+	float tmax) const
+{
+	float nearest = tmax;
+	if(nodes.empty())
+		return nearest;
+
+	const Vector3& o = ray.GetOrigin();
+	const Vector3& inv = ray.GetInvDirection();
+	const Float4 origin[3] = {Splat<Float4>(o.x), Splat<Float4>(o.y), Splat<Float4>(o.z)};
+	const Float4 invDir[3] = {Splat<Float4>(inv.x), Splat<Float4>(inv.y), Splat<Float4>(inv.z)};
+	int nearBounds[3], farBounds[3];
+	for(int a = 0; a < 3; a++)
+	{
+		nearBounds[a] = ray.GetSign(a) * 3 + a;
+		farBounds[a] = (1 - ray.GetSign(a)) * 3 + a;
+	}
+
+	// pending children : node or leaf, with the distance at which the ray
+	// enters their box
+	struct Entry
+	{
+		int child;
+		int count;
+		float tnear;
+	} stack[WIDE_BVH_STACK_SIZE];
+	int nbEntries = 0;
+	stack[nbEntries].child = 0;
+	stack[nbEntries].count = 0;
+	stack[nbEntries++].tnear = 0;
+	while(nbEntries > 0)
+	{
+		const Entry entry = stack[--nbEntries];
+		if(entry.tnear > nearest)
+			continue;
+		if(entry.count > 0)
+		{
+			float dist = test(entry.child, entry.count, ray);
+			if(dist < nearest)
+				nearest = dist;
+			continue;
+		}
+
+		// slab test of the 4 children (see Box::Intersect). The NaN produced
+		// when the origin lies on a slab parallel to the ray is ignored.
+		const Node& node = nodes[entry.child];
+		Float4 bounds[6];
+		LoadBounds(node, bounds);
+		Float4 tnear = Float4();
+		Float4 tfar = Splat<Float4>(nearest);
+		for(int a = 0; a < 3; a++)
+		{
+			tnear = Max((bounds[nearBounds[a]] - origin[a]) * invDir[a], tnear);
+			tfar = Min((bounds[farBounds[a]] - origin[a]) * invDir[a], tfar);
+		}
+		Int4 hit = tnear <= tfar;
+
+		// children hit sorted by decreasing distance, the nearest is pushed last
+		int order[WIDE_BVH_WIDTH];
+		int nbHits = 0;
+		for(int k = 0; k < WIDE_BVH_WIDTH; k++)
+		{
+			if(!hit[k] || node.count[k] < 0)
+				continue;
+			int i = nbHits++;
+			for(; i > 0 && tnear[order[i - 1]] < tnear[k]; i--)
+				order[i] = order[i - 1];
+			order[i] = k;
+		}
+		for(int i = 0; i < nbHits; i++)
+		{
+			int k = order[i];
+			stack[nbEntries].child = node.child[k];
+			stack[nbEntries].count = node.count[k];
+			stack[nbEntries++].tnear = tnear[k];
+		}
+	}
+	return nearest;
+}
+
+#endif // WIDEBVH_H